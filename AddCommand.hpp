@@ -7,6 +7,7 @@
 
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -18,59 +19,62 @@
 class AddCommand : public ICommand
 {
 public:
-    AddCommand(int pid, int core, const std::string& name, SymbolTable& table,
-        const std::string& varName, const std::string& var2Name, const std::string& var3Name,
-        std::vector<std::string>* log_list)
-        : ICommand(pid, CommandType::ADD), core_(core), name_(name),
-        table_(table), varName_(varName), var2Name_(var2Name), var3Name_(var3Name),
-        log_list_(log_list)
+    AddCommand(std::string_view varName, std::string_view var2Name, std::string_view var3Name)
+        : ICommand(CommandType::ADD), varName_(varName), var2Name_(var2Name), var3Name_(var3Name)
     {
     }
 
-    void execute() override
+    void execute(ExecutionContext& context) const override
     {
-        ST st2 = table_.fetch(var2Name_);
-        ST st3 = table_.fetch(var3Name_);
+        uint16_t lhs, rhs;
+        gather(context, lhs, rhs);
+        int result = context.lhs + context.rhs;
+        commit(context, static_cast<uint16_t>(std::min(result, 65535)));
+    }
 
-        int v2 = std::stoi(st2.value);
-        int v3 = std::stoi(st3.value);
-        int result = v2 + v3;
+    // Split form of execute() for ArithmeticBatch: read both operands,
+    // then store the saturated result and log it
+    void gather(ExecutionContext& context, uint16_t& lhs, uint16_t& rhs) const
+    {
+        context.lhs = context.symbol_table->load(var2Name_);
+        context.rhs = context.symbol_table->load(var3Name_);
+        lhs = static_cast<uint16_t>(context.lhs);
+        rhs = static_cast<uint16_t>(context.rhs);
+    }
 
-        uint16_t clampedResult = static_cast<uint16_t>(std::min(result, 65535));
-        ST resultST(ST::DataType::UINT16, std::to_string(clampedResult));
-        table_.insert(varName_, resultST);
+    void commit(ExecutionContext& context, uint16_t clampedResult) const
+    {
+        int v2 = context.lhs;
+        int v3 = context.rhs;
+        context.symbol_table->store(varName_, clampedResult);
 
         std::ostringstream oss;
 
-        oss << getCurrentTimestamp() << " Core:" << core_;
+        oss << getCurrentTimestamp() << " Core:" << context.core;
         if (sub_level_ > 0) oss << " [SUBCOMMAND-" << sub_level_ << "]";
-        oss << " \"ADD result: " << resultST.value
+        oss << " \"ADD result: " << clampedResult
             << " (" << varName_ << ") <- "
             << v2 << " (" << var2Name_ << ") + "
             << v3 << " (" << var3Name_ << ")\"";
 
         std::string log_line = oss.str();
 
-        std::ofstream outfile(name_ + ".txt", std::ios::app);
+        std::ofstream outfile(std::string(context.name) + ".txt", std::ios::app);
         outfile << log_line << std::endl;
         outfile.close();
 
-        if (log_list_) log_list_->push_back(log_line);
+        if (context.log_list) context.log_list->push_back(log_line);
     }
 
-    void setCore(int core) override
+    bool readsOperands(std::string_view var2Name, std::string_view var3Name) const
     {
-        core_ = core;
+        return var2Name_ == var2Name && var3Name_ == var3Name;
     }
 
 private:
-    int core_;
-    std::string name_;
-    std::string varName_, var2Name_, var3Name_;
-    SymbolTable& table_;
-    std::vector<std::string>* log_list_;
+    std::string_view varName_, var2Name_, var3Name_;
 
-    std::string getCurrentTimestamp()
+    std::string getCurrentTimestamp() const
     {
         auto now = std::chrono::system_clock::now();
         std::time_t time_now = std::chrono::system_clock::to_time_t(now);
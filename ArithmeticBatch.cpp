@@ -0,0 +1,106 @@
+#include "ArithmeticBatch.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ARITHMETIC_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+size_t ArithmeticBatch::stage(Operation operation, uint16_t lhs, uint16_t rhs)
+{
+    Lanes& lanes = lanes_[operation];
+    slot_operation_.push_back(operation);
+    slot_index_.push_back(lanes.lhs.size());
+    lanes.lhs.push_back(lhs);
+    lanes.rhs.push_back(rhs);
+    return slot_operation_.size() - 1;
+}
+
+void ArithmeticBatch::run()
+{
+    Lanes& add = lanes_[ADD];
+    add.result.resize(add.lhs.size());
+    addSaturating(add.lhs.data(), add.rhs.data(), add.result.data(), add.lhs.size());
+
+    Lanes& subtract = lanes_[SUBTRACT];
+    subtract.result.resize(subtract.lhs.size());
+    subtractSaturating(subtract.lhs.data(), subtract.rhs.data(), subtract.result.data(), subtract.lhs.size());
+}
+
+uint16_t ArithmeticBatch::getResult(size_t slot) const
+{
+    return lanes_[slot_operation_[slot]].result[slot_index_[slot]];
+}
+
+size_t ArithmeticBatch::size() const
+{
+    return slot_operation_.size();
+}
+
+bool ArithmeticBatch::empty() const
+{
+    return slot_operation_.empty();
+}
+
+void ArithmeticBatch::clear()
+{
+    // Keeps capacity, so a steady-state pass does not allocate
+    slot_operation_.clear();
+    slot_index_.clear();
+    for (Lanes& lanes : lanes_)
+    {
+        lanes.lhs.clear();
+        lanes.rhs.clear();
+        lanes.result.clear();
+    }
+}
+
+void ArithmeticBatch::addSaturating(const uint16_t* lhs, const uint16_t* rhs, uint16_t* result, size_t count)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), _mm256_adds_epu16(a, b));
+    }
+#elif defined(ARITHMETIC_BATCH_SSE2)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm_adds_epu16(a, b));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        unsigned sum = static_cast<unsigned>(lhs[i]) + rhs[i];
+        result[i] = static_cast<uint16_t>(sum > 65535 ? 65535 : sum);
+    }
+}
+
+void ArithmeticBatch::subtractSaturating(const uint16_t* lhs, const uint16_t* rhs, uint16_t* result, size_t count)
+{
+    size_t i = 0;
+#if defined(__AVX2__)
+    for (; i + 16 <= count; i += 16)
+    {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(result + i), _mm256_subs_epu16(a, b));
+    }
+#elif defined(ARITHMETIC_BATCH_SSE2)
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(result + i), _mm_subs_epu16(a, b));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        result[i] = lhs[i] > rhs[i] ? static_cast<uint16_t>(lhs[i] - rhs[i]) : 0;
+    }
+}
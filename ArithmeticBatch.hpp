@@ -0,0 +1,48 @@
+#ifndef ARITHMETIC_BATCH_H
+#define ARITHMETIC_BATCH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Struct-of-arrays staging for the saturating uint16 ADD and SUBTRACT
+// instructions. A pool worker stages the pending arithmetic of every core
+// it steps in one pass, runs each operation over its operand arrays in a
+// single vectorized sweep, then reads the results back by slot.
+// The sweep costs a few ns per operation. Commit, which appends the log line
+// to the process's file, costs microseconds, so batching gives no
+// measurable gain end to end (Benchmarks/ArithmeticBatchBenchmark.cpp).
+class ArithmeticBatch
+{
+public:
+    enum Operation
+    {
+        ADD,
+        SUBTRACT
+    };
+
+    size_t stage(Operation operation, uint16_t lhs, uint16_t rhs);
+    void run();
+    uint16_t getResult(size_t slot) const;
+    size_t size() const;
+    bool empty() const;
+    void clear();
+
+    static void addSaturating(const uint16_t* lhs, const uint16_t* rhs, uint16_t* result, size_t count);
+    static void subtractSaturating(const uint16_t* lhs, const uint16_t* rhs, uint16_t* result, size_t count);
+
+private:
+    struct Lanes
+    {
+        std::vector<uint16_t> lhs;
+        std::vector<uint16_t> rhs;
+        std::vector<uint16_t> result;
+    };
+
+    // Slot -> (operation, index into that operation's lanes)
+    std::vector<Operation> slot_operation_;
+    std::vector<size_t> slot_index_;
+    Lanes lanes_[2];
+};
+
+#endif
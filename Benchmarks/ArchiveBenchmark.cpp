@@ -0,0 +1,90 @@
+// Runs a million processes through the finished-process archive and reports
+// what the archive and the whole process hold afterwards. Build with
+// Benchmarks/build.sh.
+//
+// Processes go through the normal create/publish/archive path; the ready
+// queue is cleared after each publish so the archive is the only thing
+// left holding on to a finished process.
+
+#include "Clock.hpp"
+#include "ProcessManager.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+ProcessManager* GLOBAL_PM = nullptr;
+bool GLOBAL_SHUTTING_DOWN = false;
+
+namespace
+{
+    const int PROCESSES = 1000000;
+    const int INSTRUCTIONS = 100;
+
+    size_t residentBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return 0;
+        }
+        return counters.WorkingSetSize;
+#else
+        std::ifstream statm("/proc/self/statm");
+        size_t total_pages = 0;
+        size_t resident_pages = 0;
+        statm >> total_pages >> resident_pages;
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+}
+
+int main()
+{
+    Clock clock;
+    ProcessManager* manager = new ProcessManager(INSTRUCTIONS, INSTRUCTIONS, 1, "fcfs", 0, 1, &clock,
+        65536, 16, 4096, 1);
+    GLOBAL_PM = manager;
+
+    // Same shape as the timestamps ConsoleManager hands to new processes
+    const std::string time = "(10/19/2026, 10:59:17 AM)";
+    size_t rss_before = residentBytes();
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < PROCESSES; ++i)
+    {
+        std::shared_ptr<Process> process = manager->createProcess("process" + std::to_string(i), manager->reservePid());
+        manager->publishProcess(process, time, std::chrono::system_clock::now());
+        manager->getScheduler()->clearQueue();
+        manager->archiveProcess(process);
+    }
+
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    size_t rss_after = residentBytes();
+    size_t archived = manager->getFinishedCount();
+    size_t archive_bytes = manager->getArchiveBytes();
+    size_t rss_growth = rss_after > rss_before ? rss_after - rss_before : 0;
+
+    std::cout << archived << " processes archived in " << std::fixed << std::setprecision(1) << elapsed_ms << " ms\n"
+        << std::setw(12) << sizeof(ProcessRecord) << " bytes sizeof(ProcessRecord)\n"
+        << std::setw(12) << archive_bytes / 1024 << " KB archive size\n"
+        << std::setw(12) << (archived > 0 ? archive_bytes / archived : 0) << " archive bytes per process\n"
+        << std::setw(12) << rss_growth / 1024 << " KB resident growth\n"
+        << std::setw(12) << (archived > 0 ? rss_growth / archived : 0) << " resident bytes per process\n";
+
+    delete manager;
+    GLOBAL_PM = nullptr;
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Generates the instruction stream of large processes and tears it down,
+// timing each half. Build with Benchmarks/build.sh.
+//
+// Instructions moved from Process into ProgramImage after the arena was
+// introduced. Before ProgramImage.hpp exists this file drives the chunks
+// through Process instead, so it still builds in an older checkout: copy
+// Benchmarks/ into it to compare against per-instruction allocation.
+
+#if __has_include("ProgramImage.hpp")
+#include "ProgramImage.hpp"
+#define ARENA_BENCHMARK_PROGRAM_IMAGE 1
+#else
+#include "Process.hpp"
+#define ARENA_BENCHMARK_PROGRAM_IMAGE 0
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ProcessManager;
+ProcessManager* GLOBAL_PM = nullptr;
+bool GLOBAL_SHUTTING_DOWN = false;
+
+namespace
+{
+    const int PROCESSES = 50;
+    const int INSTRUCTIONS = 100000;
+    const int RUNS = 5;
+
+    struct RunResult
+    {
+        double generate_ms;
+        double teardown_ms;
+    };
+
+    RunResult generateAndTearDown()
+    {
+        RunResult result = { 0.0, 0.0 };
+        for (int p = 0; p < PROCESSES; ++p)
+        {
+            auto start = std::chrono::steady_clock::now();
+#if ARENA_BENCHMARK_PROGRAM_IMAGE
+            // A shared image keeps every chunk, as one process's program did
+            auto image = std::make_unique<ProgramImage>(1234 + p, INSTRUCTIONS, INSTRUCTIONS, false, true);
+            for (int chunk = 0; image->getChunk(chunk) != nullptr; ++chunk)
+            {
+            }
+#else
+            auto image = std::make_unique<Process>(p, "process" + std::to_string(p), "", std::chrono::system_clock::now(), 0,
+                INSTRUCTIONS, INSTRUCTIONS, 64, 16);
+            image->setSeed(1234 + p);
+            image->generateCommands(INSTRUCTIONS, INSTRUCTIONS);
+            // Chunks hold at least a few lines each; extra calls past the end do nothing
+            for (int chunk = 0; chunk < INSTRUCTIONS / 8; ++chunk)
+            {
+                image->generateNextChunk();
+            }
+#endif
+            auto generated = std::chrono::steady_clock::now();
+            image.reset();
+            auto released = std::chrono::steady_clock::now();
+
+            result.generate_ms += std::chrono::duration<double, std::milli>(generated - start).count();
+            result.teardown_ms += std::chrono::duration<double, std::milli>(released - generated).count();
+        }
+        return result;
+    }
+}
+
+int main()
+{
+    std::vector<RunResult> runs;
+    for (int i = 0; i < RUNS; ++i)
+    {
+        runs.push_back(generateAndTearDown());
+    }
+    std::sort(runs.begin(), runs.end(), [](const RunResult& a, const RunResult& b)
+        {
+            return a.generate_ms + a.teardown_ms < b.generate_ms + b.teardown_ms;
+        });
+
+    // Median run by total time
+    const RunResult& median = runs[RUNS / 2];
+    std::cout << PROCESSES << " processes x " << INSTRUCTIONS << " instructions, median of " << RUNS << " runs\n"
+        << std::fixed << std::setprecision(1)
+        << std::setw(10) << median.generate_ms << " ms generate\n"
+        << std::setw(10) << median.teardown_ms << " ms teardown\n"
+        << std::setw(10) << median.generate_ms + median.teardown_ms << " ms total\n";
+    return 0;
+}
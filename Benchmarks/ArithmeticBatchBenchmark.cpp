@@ -0,0 +1,156 @@
+// Compares ADD executed one instruction at a time with the batched path a
+// pool worker takes (gather, ArithmeticBatch::run, commit), and splits the
+// batched time into its three phases. Each pass stages one ADD per virtual
+// core, as stepCore does with instructions-per-tick 1. Build with
+// Benchmarks/build.sh.
+
+#include "AddCommand.hpp"
+#include "ArithmeticBatch.hpp"
+#include "DeclareCommand.hpp"
+#include "ExecutionContext.hpp"
+#include "SymbolTable.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ProcessManager;
+ProcessManager* GLOBAL_PM = nullptr;
+bool GLOBAL_SHUTTING_DOWN = false;
+
+namespace
+{
+    const int CORES = 8;
+    const int PASSES = 20000;
+    const int RUNS = 5;
+
+    struct Core
+    {
+        std::string name;
+        SymbolTable symbol_table;
+        ExecutionContext context;
+    };
+
+    struct RunResult
+    {
+        double scalar_ms;
+        double gather_ms;
+        double kernel_ms;
+        double commit_ms;
+
+        double batched_ms() const
+        {
+            return gather_ms + kernel_ms + commit_ms;
+        }
+    };
+
+    std::vector<std::unique_ptr<Core>> createCores()
+    {
+        std::vector<std::unique_ptr<Core>> cores;
+        for (int i = 0; i < CORES; ++i)
+        {
+            auto core = std::make_unique<Core>();
+            core->name = "arith" + std::to_string(i);
+            core->context.pid = i + 1;
+            core->context.core = i + 1;
+            core->context.name = core->name;
+            core->context.symbol_table = &core->symbol_table;
+            DeclareCommand("lhs", static_cast<uint16_t>(1000 + i)).execute(core->context);
+            DeclareCommand("rhs", static_cast<uint16_t>(7)).execute(core->context);
+            cores.push_back(std::move(core));
+        }
+        return cores;
+    }
+
+    void removeLogs(const std::vector<std::unique_ptr<Core>>& cores)
+    {
+        for (const auto& core : cores)
+        {
+            std::remove((core->name + ".txt").c_str());
+        }
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    RunResult runOnce()
+    {
+        // sum = lhs + rhs, so operands never change and both paths do the same work
+        const AddCommand add("sum", "lhs", "rhs");
+        RunResult result = { 0.0, 0.0, 0.0, 0.0 };
+
+        std::vector<std::unique_ptr<Core>> cores = createCores();
+        auto start = std::chrono::steady_clock::now();
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            for (auto& core : cores)
+            {
+                add.execute(core->context);
+            }
+        }
+        result.scalar_ms = elapsedMs(start);
+        removeLogs(cores);
+
+        cores = createCores();
+        ArithmeticBatch batch;
+        std::vector<size_t> slots(CORES);
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            auto phase = std::chrono::steady_clock::now();
+            for (int i = 0; i < CORES; ++i)
+            {
+                uint16_t lhs;
+                uint16_t rhs;
+                add.gather(cores[i]->context, lhs, rhs);
+                slots[i] = batch.stage(ArithmeticBatch::ADD, lhs, rhs);
+            }
+            result.gather_ms += elapsedMs(phase);
+
+            phase = std::chrono::steady_clock::now();
+            batch.run();
+            result.kernel_ms += elapsedMs(phase);
+
+            phase = std::chrono::steady_clock::now();
+            for (int i = 0; i < CORES; ++i)
+            {
+                add.commit(cores[i]->context, batch.getResult(slots[i]));
+            }
+            batch.clear();
+            result.commit_ms += elapsedMs(phase);
+        }
+        removeLogs(cores);
+        return result;
+    }
+}
+
+int main()
+{
+    std::vector<RunResult> runs;
+    for (int i = 0; i < RUNS; ++i)
+    {
+        runs.push_back(runOnce());
+    }
+    std::sort(runs.begin(), runs.end(), [](const RunResult& a, const RunResult& b)
+        {
+            return a.batched_ms() < b.batched_ms();
+        });
+
+    // Median run by batched time
+    const RunResult& median = runs[RUNS / 2];
+    const double ops = static_cast<double>(CORES) * PASSES;
+    std::cout << CORES << " cores x " << PASSES << " passes of ADD, median of " << RUNS << " runs\n"
+        << std::fixed << std::setprecision(1)
+        << std::setw(10) << median.scalar_ms * 1e6 / ops << " ns/op unbatched\n"
+        << std::setw(10) << median.batched_ms() * 1e6 / ops << " ns/op batched\n"
+        << std::setw(10) << median.gather_ms * 1e6 / ops << " ns/op   gather and stage\n"
+        << std::setw(10) << median.kernel_ms * 1e6 / ops << " ns/op   vector kernel\n"
+        << std::setw(10) << median.commit_ms * 1e6 / ops << " ns/op   commit and log\n";
+    return 0;
+}
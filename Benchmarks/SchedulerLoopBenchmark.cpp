@@ -0,0 +1,233 @@
+// Measures the scheduling loop itself rather than the clock it runs on.
+// Each policy drains the same batch of processes on one core with switch
+// costs off and, where the tree has it, a whole process per tick, so host
+// time is instruction execution plus loop overhead. A direct run of the
+// same programs on one thread gives the execution part; what the policy
+// adds on top is reported per instruction and per dispatch. Run it from a
+// scratch directory: time-sliced policies write a memory stamp under
+// outputs/ for every full quantum, as they do in a normal run.
+//
+// The file only uses interfaces that predate the merged scheduling loop,
+// so it can be copied into an older checkout and built there with
+// Benchmarks/build.sh for a before/after comparison.
+
+#include "Clock.hpp"
+#include "ProcessManager.hpp"
+#include "ProcessRecord.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+ProcessManager* GLOBAL_PM = nullptr;
+bool GLOBAL_SHUTTING_DOWN = false;
+
+namespace
+{
+    const int NUM_CPU = 1;
+    const int PROCESSES = 32;
+    const int INSTRUCTIONS = 1000;
+    const int QUANTUM = 5;
+    const int RUNS = 3;
+    const uint32_t SEED = 1;
+
+    struct RunResult
+    {
+        double host_ms;
+        long long dispatches;
+    };
+
+    ProcessManager* createManager(Clock& clock, const std::string& policy)
+    {
+        ProcessManager* manager = new ProcessManager(INSTRUCTIONS, INSTRUCTIONS, NUM_CPU, policy, 0, QUANTUM, &clock,
+            1 << 20, 16, 4096, 1);
+        // Every run executes the same programs
+        manager->setGlobalSeed(SEED);
+        GLOBAL_PM = manager;
+        return manager;
+    }
+
+    void removeLogs()
+    {
+        for (int i = 0; i < PROCESSES; ++i)
+        {
+            std::remove(("bench" + std::to_string(i) + ".txt").c_str());
+        }
+    }
+
+    // Returns false when the tree predates instructions-per-tick, where
+    // run-to-completion policies wait a tick per instruction
+    template <typename S>
+    bool configureLoopOnly(S& scheduler)
+    {
+        // Simulated switch costs would have the core wait ticks between dispatches
+        scheduler.setSwitchCosts(0, 0, 0);
+        if constexpr (requires { scheduler.setInstructionsPerTick(INSTRUCTIONS); })
+        {
+            // A whole process per tick, so run-to-completion policies wait
+            // for the clock once per dispatch instead of once per instruction
+            scheduler.setInstructionsPerTick(INSTRUCTIONS);
+            return true;
+        }
+        return false;
+    }
+
+    RunResult runDirect()
+    {
+        Clock clock;
+        ProcessManager* manager = createManager(clock, "fcfs");
+
+        std::vector<std::shared_ptr<Process>> processes;
+        for (int i = 0; i < PROCESSES; ++i)
+        {
+            processes.push_back(manager->createProcess("bench" + std::to_string(i), manager->reservePid()));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (const std::shared_ptr<Process>& process : processes)
+        {
+            while (process->getCommandCounter() < process->getLinesOfCode())
+            {
+                process->executeCurrentCommand();
+            }
+        }
+
+        RunResult result;
+        result.host_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        result.dispatches = 0;
+
+        processes.clear();
+        delete manager;
+        GLOBAL_PM = nullptr;
+        removeLogs();
+        return result;
+    }
+
+    RunResult drain(const std::string& policy)
+    {
+        Clock clock;
+        clock.startCpuClock();
+        ProcessManager* manager = createManager(clock, policy);
+        configureLoopOnly(*manager->getScheduler());
+
+        std::vector<std::string> names;
+        for (int i = 0; i < PROCESSES; ++i)
+        {
+            names.push_back("bench" + std::to_string(i));
+            manager->addProcess(names.back(), "", std::chrono::system_clock::now());
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        manager->start();
+
+        ProcessRecord record;
+        size_t finished = 0;
+        while (finished < names.size())
+        {
+            if (manager->getFinishedProcess(names[finished], record))
+            {
+                finished++;
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        }
+
+        RunResult result;
+        result.host_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        // Every dispatch after the first on a core is counted as a switch
+        std::vector<long long> counts;
+        std::vector<long long> ticks;
+        manager->getScheduler()->getSwitchStats(counts, ticks);
+        result.dispatches = NUM_CPU;
+        for (long long count : counts)
+        {
+            result.dispatches += count;
+        }
+
+        delete manager;
+        GLOBAL_PM = nullptr;
+        clock.stopCpuClock();
+        removeLogs();
+        return result;
+    }
+
+    RunResult median(std::vector<RunResult> runs)
+    {
+        std::sort(runs.begin(), runs.end(), [](const RunResult& a, const RunResult& b)
+            {
+                return a.host_ms < b.host_ms;
+            });
+        return runs[runs.size() / 2];
+    }
+}
+
+int main()
+{
+    std::vector<RunResult> direct_runs;
+    for (int i = 0; i < RUNS; ++i)
+    {
+        direct_runs.push_back(runDirect());
+    }
+    RunResult direct = median(direct_runs);
+
+    Clock probe_clock;
+    ProcessManager* probe = createManager(probe_clock, "fcfs");
+    bool instructions_per_tick = configureLoopOnly(*probe->getScheduler());
+    delete probe;
+    GLOBAL_PM = nullptr;
+
+    std::vector<std::string> policies = { "rr", "mlfq" };
+    if (instructions_per_tick)
+    {
+        policies.insert(policies.begin(), { "fcfs", "sjf" });
+    }
+
+    const double instructions = static_cast<double>(PROCESSES) * INSTRUCTIONS;
+    std::vector<std::string> lines;
+    for (const std::string& policy : policies)
+    {
+        std::vector<RunResult> runs;
+        for (int i = 0; i < RUNS; ++i)
+        {
+            runs.push_back(drain(policy));
+        }
+        RunResult result = median(runs);
+
+        double loop_ns = (result.host_ms - direct.host_ms) * 1e6;
+        std::ostringstream line;
+        line << std::left << std::setw(8) << policy << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << result.host_ms
+            << std::setw(12) << result.dispatches
+            << std::setw(12) << result.host_ms * 1e6 / instructions
+            << std::setw(12) << loop_ns / instructions
+            << std::setw(14) << loop_ns / result.dispatches;
+        lines.push_back(line.str());
+    }
+
+    std::cout << "\n" << PROCESSES << " processes x " << INSTRUCTIONS << " instructions on " << NUM_CPU
+        << " core, quantum " << QUANTUM << ", median of " << RUNS << " runs\n"
+        << std::left << std::setw(8) << "policy" << std::right
+        << std::setw(10) << "host ms" << std::setw(12) << "dispatches" << std::setw(12) << "ns/instr"
+        << std::setw(12) << "loop ns/ins" << std::setw(14) << "loop ns/disp" << "\n"
+        << std::left << std::setw(8) << "direct" << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << direct.host_ms << std::setw(12) << "-"
+        << std::setw(12) << direct.host_ms * 1e6 / instructions << "\n";
+    for (const std::string& line : lines)
+    {
+        std::cout << line << "\n";
+    }
+    if (!instructions_per_tick)
+    {
+        std::cout << "fcfs and sjf skipped: no instructions-per-tick in this tree\n";
+    }
+    return 0;
+}
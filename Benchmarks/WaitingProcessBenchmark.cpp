@@ -0,0 +1,77 @@
+// Builds a batch of processes and holds them without dispatching any, the
+// way they sit in the ready queue, then reports what one waiting process
+// costs. Build with Benchmarks/build.sh.
+
+#include "Clock.hpp"
+#include "ProcessManager.hpp"
+
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define PSAPI_VERSION 2
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <fstream>
+#include <unistd.h>
+#endif
+
+ProcessManager* GLOBAL_PM = nullptr;
+bool GLOBAL_SHUTTING_DOWN = false;
+
+namespace
+{
+    const int PROCESSES = 100000;
+    const int INSTRUCTIONS = 1000;
+
+    size_t residentBytes()
+    {
+#ifdef _WIN32
+        PROCESS_MEMORY_COUNTERS counters;
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        {
+            return 0;
+        }
+        return counters.WorkingSetSize;
+#else
+        std::ifstream statm("/proc/self/statm");
+        size_t total_pages = 0;
+        size_t resident_pages = 0;
+        statm >> total_pages >> resident_pages;
+        return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+    }
+}
+
+int main()
+{
+    Clock clock;
+    ProcessManager* manager = new ProcessManager(INSTRUCTIONS, INSTRUCTIONS, 1, "fcfs", 0, 1, &clock,
+        65536, 16, 4096, 1);
+    GLOBAL_PM = manager;
+
+    std::vector<std::shared_ptr<Process>> waiting;
+    waiting.reserve(PROCESSES);
+    size_t rss_before = residentBytes();
+
+    for (int i = 0; i < PROCESSES; ++i)
+    {
+        waiting.push_back(manager->createProcess("process" + std::to_string(i), manager->reservePid()));
+    }
+
+    size_t rss_growth = residentBytes() - rss_before;
+    std::cout << PROCESSES << " waiting processes of " << INSTRUCTIONS << " instructions\n"
+        << std::setw(12) << sizeof(Process) << " bytes sizeof(Process)\n"
+        << std::setw(12) << sizeof(ProgramImage) << " bytes sizeof(ProgramImage)\n"
+        << std::setw(12) << rss_growth / PROCESSES << " resident bytes per process\n";
+
+    waiting.clear();
+    delete manager;
+    GLOBAL_PM = nullptr;
+    return 0;
+}
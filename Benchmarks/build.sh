@@ -0,0 +1,9 @@
+#!/usr/bin/env bash
+# Builds each benchmark against the simulator sources, minus Main.cpp.
+# Override CXX to build with a native compiler.
+cd "$(dirname "$0")"
+CXX=${CXX:-i686-w64-mingw32-c++}
+SOURCES=$(ls ../*.cpp | grep -v '/Main\.cpp$')
+for BENCH in *.cpp; do
+    $CXX -static -static-libgcc -static-libstdc++ -O2 -Wall -Wextra -std=c++20 -I.. $SOURCES "$BENCH" -o "${BENCH%.cpp}.exe" || exit 1
+done
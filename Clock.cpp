@@ -1,9 +1,20 @@
 #include "Clock.hpp"
+#include "ThreadAffinity.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <time.h>
+#endif
 
 Clock::Clock() : cpu_clock(0), active_num(0)
 {
 }
 
+long long Clock::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
 int Clock::getCpuClock()
 {
     return cpu_clock.load();
@@ -17,24 +28,214 @@ void Clock::startCpuClock()
         std::cout << "CPU Clock started\n";
         cpu_clock_thread = std::thread([this]()
         {
+            const std::chrono::microseconds period(tick_period_us_);
+            auto deadline = std::chrono::steady_clock::now();
+
             while (is_running)
             {
+                std::chrono::steady_clock::duration held = waitForWindow(cpu_clock.load() + 1);
+
+                // Loaded before publishing; the first tick published under the
+                // barrier is recorded for enableLockstep
+                std::barrier<>* barrier = lockstep_barrier_.load();
+                if (barrier && lockstep_tick_.load() == 0)
+                {
+                    lockstep_tick_ = cpu_clock.load() + 1;
+                }
+
+                tick_published_ns_ = nowNs();
+                cpu_clock.fetch_add(1);
+                cpu_clock.notify_all();
+
+                // Lockstep: the next tick starts only once every participant is done with this one
+                if (barrier)
+                {
+                    auto arrived = std::chrono::steady_clock::now();
+                    barrier->arrive_and_wait();
+                    held += std::chrono::steady_clock::now() - arrived;
+                }
+
+                held_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(held).count();
+                deadline += period;
+                auto now = std::chrono::steady_clock::now();
+                if (now > deadline && held > std::chrono::steady_clock::duration::zero())
+                {
+                    // Waiting for the cores is backpressure, not host lag: the
+                    // part of it that ran past the deadline moves the schedule
+                    // back instead of counting as late or missed
+                    deadline += std::min<std::chrono::steady_clock::duration>(now - deadline, held);
+                }
+                if (now >= deadline + period)
                 {
-                    std::lock_guard<std::mutex> lock(clock_mutex);
-                    cpu_clock++;
+                    // Fell at least one whole period behind: skip those ticks.
+                    // The overrun is counted here only, not again as late.
+                    long long missed = (now - deadline) / period;
+                    missed_ticks_ += missed;
+                    deadline += missed * period;
+                    continue;
                 }
 
-                cycle_condition.notify_all();
+                sleepUntil(deadline);
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                long long jitter = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - deadline).count();
+                tick_jitter_.record(static_cast<uint64_t>(std::max(0LL, jitter)));
+                if (jitter * 10 > std::chrono::duration_cast<std::chrono::nanoseconds>(period).count())
+                {
+                    // More than 10% of a period past the deadline
+                    late_ticks_++;
+                }
             }
+
+            std::barrier<>* barrier = lockstep_barrier_.load();
+            if (barrier)
+            {
+                barrier->arrive_and_drop();
+            }
+
+            // Release anyone still waiting for a tick
+            cpu_clock.fetch_add(1);
+            cpu_clock.notify_all();
         });
+
+        applyPlacement();
     }
 }
 
+void Clock::applyPlacement()
+{
+    std::string error;
+    if (host_cpu_ >= 0)
+    {
+        if (ThreadAffinity::pin(cpu_clock_thread, host_cpu_, error))
+        {
+            pinned_cpu_ = host_cpu_;
+        }
+        else
+        {
+            std::cerr << "[WARNING] Clock thread: " << error << std::endl;
+        }
+    }
+    if (realtime_)
+    {
+        if (ThreadAffinity::setRealtime(cpu_clock_thread, error))
+        {
+            realtime_applied_ = true;
+        }
+        else
+        {
+            std::cerr << "[WARNING] Clock thread: " << error << std::endl;
+        }
+    }
+}
+
+void Clock::setPlacement(int host_cpu, bool realtime)
+{
+    // Takes effect the next time the clock starts
+    host_cpu_ = host_cpu;
+    realtime_ = realtime;
+}
+
+int Clock::getPinnedCpu() const
+{
+    return pinned_cpu_;
+}
+
+bool Clock::isRealtime() const
+{
+    return realtime_applied_;
+}
+
+void Clock::sleepUntil(std::chrono::steady_clock::time_point deadline)
+{
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC on Linux, so the deadline maps directly
+    auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    timespec target;
+    target.tv_sec = static_cast<time_t>(since_epoch / 1000000000LL);
+    target.tv_nsec = static_cast<long>(since_epoch % 1000000000LL);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &target, nullptr) == EINTR)
+    {
+    }
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+void Clock::setTickPeriod(int tick_period_us)
+{
+    // Takes effect the next time the clock starts
+    tick_period_us_ = std::max(1, tick_period_us);
+}
+
+int Clock::getTickPeriod() const
+{
+    return tick_period_us_;
+}
+
+long long Clock::getLateTicks() const
+{
+    return late_ticks_.load();
+}
+
+long long Clock::getMissedTicks() const
+{
+    return missed_ticks_.load();
+}
+
+long long Clock::getHeldNs() const
+{
+    return held_ns_.load();
+}
+
+const LatencyHistogram& Clock::getTickJitter() const
+{
+    return tick_jitter_;
+}
+
+void Clock::enableWindow(int lookahead, int floor)
+{
+    window_lookahead_ = lookahead;
+    window_floor_ = floor;
+    window_enabled_ = true;
+}
+
+void Clock::advanceWindow(int floor)
+{
+    int current = window_floor_.load();
+    while (current < floor && !window_floor_.compare_exchange_weak(current, floor))
+    {
+    }
+    window_floor_.notify_all();
+}
+
+void Clock::disableWindow()
+{
+    window_enabled_ = false;
+    window_floor_.fetch_add(1);
+    window_floor_.notify_all();
+}
+
+std::chrono::steady_clock::duration Clock::waitForWindow(int tick)
+{
+    int floor = window_floor_.load();
+    if (!window_enabled_ || tick <= floor + window_lookahead_)
+    {
+        return std::chrono::steady_clock::duration::zero();
+    }
+
+    auto from = std::chrono::steady_clock::now();
+    while (window_enabled_ && is_running && tick > floor + window_lookahead_)
+    {
+        window_floor_.wait(floor);
+        floor = window_floor_.load();
+    }
+    return std::chrono::steady_clock::now() - from;
+}
+
 void Clock::stopCpuClock()
 {
     is_running = false;
+    disableWindow();
     if (cpu_clock_thread.joinable())
     {
         cpu_clock_thread.join();
@@ -42,6 +243,65 @@ void Clock::stopCpuClock()
     }
 }
 
+int Clock::waitForTick(int last_tick)
+{
+    int tick = cpu_clock.load();
+    if (tick > last_tick)
+    {
+        return tick;
+    }
+
+    while (tick <= last_tick)
+    {
+        cpu_clock.wait(tick);
+        tick = cpu_clock.load();
+    }
+
+    wakeup_latency_.record(static_cast<uint64_t>(std::max(0LL, nowNs() - tick_published_ns_.load())));
+    return tick;
+}
+
+void Clock::enableLockstep(int participants)
+{
+    // Set once before the participants start; the clock thread counts as one more
+    lockstep_ = std::make_unique<std::barrier<>>(participants + 1);
+    lockstep_barrier_ = lockstep_.get();
+
+    // Return once the clock is holding the first tick it waits on. A
+    // participant that stepped an earlier tick would arrive once too often
+    // and complete a phase without the clock.
+    int tick = cpu_clock.load();
+    while (is_running && (lockstep_tick_.load() == 0 || tick < lockstep_tick_.load()))
+    {
+        tick = waitForTick(tick);
+    }
+}
+
+void Clock::arriveTick()
+{
+    std::barrier<>* barrier = lockstep_barrier_.load();
+    if (barrier)
+    {
+        // Don't wait for the others; the participant's next waitForTick does that
+        auto token = barrier->arrive();
+        (void)token;
+    }
+}
+
+void Clock::leaveLockstep()
+{
+    std::barrier<>* barrier = lockstep_barrier_.load();
+    if (barrier)
+    {
+        barrier->arrive_and_drop();
+    }
+}
+
+const LatencyHistogram& Clock::getWakeupLatency() const
+{
+    return wakeup_latency_;
+}
+
 std::atomic<int> Clock::getActiveCpuNum()
 {
     return active_num.load();
@@ -50,4 +310,4 @@ std::atomic<int> Clock::getActiveCpuNum()
 void Clock::incrementActiveCpuNum()
 {
     active_num++;
-}
\ No newline at end of file
+}
@@ -1,12 +1,28 @@
 #ifndef CLOCK_H
 #define CLOCK_H
 
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
 #include <atomic>
-#include <condition_variable>
+#include <barrier>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <thread>
-#include <mutex>
 
+// The tick counter doubles as a lock-free epoch: waiters block in
+// waitForTick on the atomic itself (a futex on Linux) instead of on a shared
+// mutex and condition variable. In lockstep mode the clock thread also waits
+// on a barrier for every registered participant to finish the current tick.
+// Ticks fire on absolute deadlines, one tick period apart, so oversleeping
+// never accumulates into drift; a deadline missed by a whole period is skipped
+// and counted rather than fired late in a burst.
+// In windowed mode (conservative PDES) there is no per-tick barrier: the
+// clock only holds back a tick that would run more than the lookahead past
+// the slowest participant's published floor. Time held back by the barrier
+// or the window shifts the schedule and is reported separately, so it never
+// shows up as late or missed ticks.
 class Clock
 {
 public:
@@ -16,22 +32,52 @@ public:
     void stopCpuClock();
     std::atomic<int> getActiveCpuNum();
     void incrementActiveCpuNum();
-    std::condition_variable& getCondition()
-    {
-        return cycle_condition;
-    }
-    std::mutex& getMutex()
-    {
-        return clock_mutex;
-    }
+    int waitForTick(int last_tick);
+    void enableLockstep(int participants);
+    void arriveTick();
+    void leaveLockstep();
+    void enableWindow(int lookahead, int floor);
+    void advanceWindow(int floor);
+    void disableWindow();
+    const LatencyHistogram& getWakeupLatency() const;
+    void setTickPeriod(int tick_period_us);
+    int getTickPeriod() const;
+    long long getLateTicks() const;
+    long long getMissedTicks() const;
+    // Time the clock spent held back by lockstep or the PDES window
+    long long getHeldNs() const;
+    const LatencyHistogram& getTickJitter() const;
+    void setPlacement(int host_cpu, bool realtime);
+    int getPinnedCpu() const;
+    bool isRealtime() const;
 
 private:
+    static long long nowNs();
+    void sleepUntil(std::chrono::steady_clock::time_point deadline);
+    void applyPlacement();
+    std::chrono::steady_clock::duration waitForWindow(int tick);
+
     std::atomic<int> cpu_clock;
-    bool is_running = false;
+    std::atomic<bool> is_running{ false };
     std::thread cpu_clock_thread;
-    std::condition_variable cycle_condition;
-    std::mutex clock_mutex;
     std::atomic<int> active_num;
+    std::atomic<long long> tick_published_ns_{ 0 };
+    std::unique_ptr<std::barrier<>> lockstep_;
+    std::atomic<std::barrier<>*> lockstep_barrier_{ nullptr };
+    std::atomic<int> lockstep_tick_{ 0 };
+    LatencyHistogram wakeup_latency_;
+    std::atomic<bool> window_enabled_{ false };
+    std::atomic<int> window_floor_{ 0 };
+    int window_lookahead_ = 0;
+    int tick_period_us_ = 1000;
+    std::atomic<long long> late_ticks_{ 0 };
+    std::atomic<long long> missed_ticks_{ 0 };
+    std::atomic<long long> held_ns_{ 0 };
+    LatencyHistogram tick_jitter_;
+    int host_cpu_ = -1;
+    bool realtime_ = false;
+    int pinned_cpu_ = -1;
+    bool realtime_applied_ = false;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,39 @@
+#include "CommandArena.hpp"
+
+#include <cstring>
+
+CommandArena::CommandArena(size_t block_bytes)
+    : block_bytes_(block_bytes)
+{
+}
+
+std::pmr::monotonic_buffer_resource& CommandArena::resource()
+{
+    if (!resource_)
+    {
+        if (!first_block_)
+        {
+            first_block_ = std::make_unique_for_overwrite<std::byte[]>(block_bytes_);
+        }
+        // Blocks past the first come from the default heap and are handed
+        // back together on release()
+        resource_.emplace(first_block_.get(), block_bytes_);
+    }
+    return *resource_;
+}
+
+std::string_view CommandArena::intern(std::string_view text)
+{
+    char* storage = static_cast<char*>(resource().allocate(text.size() + 1, alignof(char)));
+    std::memcpy(storage, text.data(), text.size());
+    storage[text.size()] = '\0';
+    return std::string_view(storage, text.size());
+}
+
+void CommandArena::reset()
+{
+    if (resource_)
+    {
+        resource_->release();
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef COMMAND_ARENA_H
+#define COMMAND_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+// Per-process monotonic arena for generated instructions and the strings
+// they refer to. Objects are bump-allocated and never destroyed one by
+// one: reset() drops everything at once and rewinds to the first block,
+// so only trivially-owned members (views into this arena, raw pointers,
+// scalars) may live in an arena object.
+class CommandArena
+{
+public:
+    static constexpr size_t DEFAULT_BLOCK_BYTES = 16 * 1024;
+
+    explicit CommandArena(size_t block_bytes = DEFAULT_BLOCK_BYTES);
+    CommandArena(const CommandArena&) = delete;
+    CommandArena& operator=(const CommandArena&) = delete;
+
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        void* storage = resource().allocate(sizeof(T), alignof(T));
+        return ::new (storage) T(std::forward<Args>(args)...);
+    }
+
+    // Copies text into the arena; the view stays valid until reset(), so
+    // strings shared by many commands are interned once and passed around
+    std::string_view intern(std::string_view text);
+
+    void reset();
+
+private:
+    size_t block_bytes_;
+    // The first block is kept across resets; created on first use so idle
+    // processes cost nothing
+    std::unique_ptr<std::byte[]> first_block_;
+    std::optional<std::pmr::monotonic_buffer_resource> resource_;
+
+    std::pmr::monotonic_buffer_resource& resource();
+};
+
+#endif
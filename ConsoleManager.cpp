@@ -1,14 +1,16 @@
 #include "ConsoleManager.hpp"
 #include "Globals.hpp"
+#include "ThreadAffinity.hpp"
 
 #include <filesystem>
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
+#include <deque>
 
 
-void ConsoleManager::createSession(const std::string& name)
+void ConsoleManager::createSession(const std::string& name, int deadline_offset)
 {
     if (screens.find(name) != screens.end())
     {
@@ -19,7 +21,7 @@ void ConsoleManager::createSession(const std::string& name)
     Screen new_screen = {"Process-" + name, 0, 100, screen_manager.getCurrentTimestamp()};
     screens[name] = new_screen;
 
-    process_manager->addProcess(name, screen_manager.getCurrentTimestamp(), screen_manager.getCreationTime());
+    process_manager->addProcess(name, screen_manager.getCurrentTimestamp(), screen_manager.getCreationTime(), deadline_offset);
 
     std::cout << "Created screen: " << name << std::endl;
     system("cls");
@@ -27,24 +29,148 @@ void ConsoleManager::createSession(const std::string& name)
     screen_manager.displayScreen(process_manager->getProcess(name));
 }
 
-void ConsoleManager::generateSession(const std::string& name)
+void ConsoleManager::generateSession(std::shared_ptr<Process> process)
 {
-    if (screens.find(name) != screens.end())
-    {
-        std::cout << "Screen '" << name << "' already exists. Reattaching...\n";
-        return;
-    }
+    const std::string& name = process->getName();
 
     Screen new_screen = {"process" + name, 0, 100, screen_manager.getCurrentTimestamp()};
     screens[name] = new_screen;
 
-    process_manager->addProcess(name, screen_manager.getCurrentTimestamp(), screen_manager.getCreationTime());
-    process_manager->getProcess(name);
+    process->setDeadlineOffset(batch_deadline);
+    process_manager->publishProcess(process, screen_manager.getCurrentTimestamp(), screen_manager.getCreationTime());
+}
+
+void ConsoleManager::printAffinity()
+{
+    std::cout << "Clock thread -> ";
+    if (cpu_clock->getPinnedCpu() >= 0)
+    {
+        std::cout << "host CPU " << cpu_clock->getPinnedCpu();
+    }
+    else
+    {
+        std::cout << "unpinned";
+    }
+    std::cout << (cpu_clock->isRealtime() ? " (SCHED_FIFO)" : "") << std::endl;
+
+    process_manager->getScheduler()->waitUntilStarted();
+    std::vector<int> workers = process_manager->getScheduler()->getWorkerAffinity();
+    for (size_t i = 0; i < workers.size(); ++i)
+    {
+        std::cout << "Worker " << i << " -> ";
+        if (workers[i] >= 0)
+        {
+            std::cout << "host CPU " << workers[i] << std::endl;
+        }
+        else
+        {
+            std::cout << "unpinned" << std::endl;
+        }
+    }
+}
+
+// Reads one config value, keeping the current setting if it doesn't parse
+// (booleans are 0 or 1); the caller reports the failure
+template <typename T>
+static bool readConfigValue(std::ifstream& config_file, T& target)
+{
+    T value;
+    if (config_file >> value)
+    {
+        target = value;
+        return true;
+    }
+    return false;
+}
+
+void ConsoleManager::loadConfig(std::ifstream& config_file)
+{
+    std::string key;
+    std::string temp;
+
+    while (config_file >> key)
+    {
+        if (key == "num-cpu") readConfigValue(config_file, num_cpu);
+        else if (key == "scheduler") config_file >> std::quoted(scheduler);
+        else if (key == "quantum-cycles") readConfigValue(config_file, quantum_cycles);
+        else if (key == "batch-process-freq") readConfigValue(config_file, batch_process_freq);
+        else if (key == "min-ins") readConfigValue(config_file, min_ins);
+        else if (key == "max-ins") readConfigValue(config_file, max_ins);
+        else if (key == "delay-per-exec") readConfigValue(config_file, delays_per_exec);
+        else if (key == "max-overall-mem") readConfigValue(config_file, max_overall_mem);
+        else if (key == "mem-per-frame") readConfigValue(config_file, mem_per_frame);
+        else if (key == "mem-per-proc") readConfigValue(config_file, mem_per_proc);
+        else if (key == "creation-threads") readConfigValue(config_file, creation_threads);
+        else if (key == "seed") has_seed = readConfigValue(config_file, seed);
+        else if (key == "trace-file") config_file >> std::quoted(trace_file);
+        else if (key == "replay-file") config_file >> std::quoted(replay_file);
+        else if (key == "mlfq-quanta")
+        {
+            // Quoted list with one quantum per level, highest priority first
+            std::string quanta;
+            config_file >> std::quoted(quanta);
+            std::istringstream iss(quanta);
+            int quantum;
+            mlfq_quanta.clear();
+            while (iss >> quantum)
+            {
+                // A level with no quantum would never run its processes
+                if (quantum <= 0)
+                {
+                    std::cerr << "[WARNING] mlfq-quanta entry " << quantum << " must be positive; level ignored." << std::endl;
+                    continue;
+                }
+                mlfq_quanta.push_back(quantum);
+            }
+        }
+        else if (key == "mlfq-boost-ticks") readConfigValue(config_file, mlfq_boost_ticks);
+        else if (key == "aging-rate") readConfigValue(config_file, aging_rate);
+        else if (key == "batch-deadline") readConfigValue(config_file, batch_deadline);
+        else if (key == "affinity-window") readConfigValue(config_file, affinity_window);
+        else if (key == "affinity-pinning") readConfigValue(config_file, affinity_pinning);
+        else if (key == "switch-cost-same-process") has_switch_costs |= readConfigValue(config_file, switch_cost_same_process);
+        else if (key == "switch-cost-same-core") has_switch_costs |= readConfigValue(config_file, switch_cost_same_core);
+        else if (key == "switch-cost-migration") has_switch_costs |= readConfigValue(config_file, switch_cost_migration);
+        else if (key == "adaptive-quantum") readConfigValue(config_file, adaptive_quantum);
+        else if (key == "quantum-min") readConfigValue(config_file, quantum_min);
+        else if (key == "quantum-max") readConfigValue(config_file, quantum_max);
+        else if (key == "quantum-adapt-ticks") readConfigValue(config_file, quantum_adapt_ticks);
+        else if (key == "instructions-per-tick") readConfigValue(config_file, instructions_per_tick);
+        else if (key == "execution-mode") config_file >> std::quoted(execution_mode);
+        else if (key == "worker-threads") readConfigValue(config_file, worker_threads);
+        else if (key == "tick-lockstep") readConfigValue(config_file, tick_lockstep);
+        else if (key == "lookahead-ticks") readConfigValue(config_file, lookahead_ticks);
+        else if (key == "batch-arithmetic") readConfigValue(config_file, batch_arithmetic);
+        else if (key == "fuse-instructions") readConfigValue(config_file, fuse_instructions);
+        else if (key == "program-templates") readConfigValue(config_file, program_templates);
+        else if (key == "tick-period-us") readConfigValue(config_file, tick_period_us);
+        else if (key == "worker-cpus") config_file >> std::quoted(worker_cpus);
+        else if (key == "clock-cpu") readConfigValue(config_file, clock_cpu);
+        else if (key == "clock-realtime") readConfigValue(config_file, clock_realtime);
+        else
+        {
+            std::getline(config_file, temp);
+            std::cerr << "[WARNING] Unknown config key \"" << key << "\" ignored." << std::endl;
+        }
+
+        // A value that doesn't parse would leave the stream failed and end
+        // the loop, silently dropping every key after it
+        if (config_file.fail() && !config_file.eof())
+        {
+            std::cerr << "[WARNING] Invalid value for config key \"" << key << "\" ignored." << std::endl;
+            config_file.clear();
+            std::getline(config_file, temp);
+        }
+        else if (config_file.fail())
+        {
+            std::cerr << "[WARNING] Missing value for config key \"" << key << "\" ignored." << std::endl;
+        }
+    }
 }
 
 void ConsoleManager::displayAllScreens()
 {
-    screen_manager.displayAllProcess(process_manager->getAllProcess(), num_cpu);
+    screen_manager.displayAllProcess(process_manager->getAllProcess(), *process_manager, num_cpu);
 }
 
 void ConsoleManager::getInput(const std::string& command)
@@ -63,29 +189,121 @@ void ConsoleManager::getInput(const std::string& command)
         screen_manager.displayHeader();
         std::ifstream config_file("config.txt");
 
-        std::string temp;
-
         if (config_file.is_open())
         {
-            config_file >> temp >> num_cpu;  
-            config_file >> temp >> std::quoted(scheduler);  
-            config_file >> temp >> quantum_cycles;  
-            config_file >> temp >> batch_process_freq;  
-            config_file >> temp >> min_ins;  
-            config_file >> temp >> max_ins;  
-            config_file >> temp >> delays_per_exec;  
-            config_file >> temp >> max_overall_mem;
-            config_file >> temp >> mem_per_frame;
-            config_file >> temp >> mem_per_proc;
+            loadConfig(config_file);
 
             config_file.close();
 
             cpu_clock = new Clock();
+            cpu_clock->setTickPeriod(tick_period_us);
+            cpu_clock->setPlacement(clock_cpu, clock_realtime);
             cpu_clock->startCpuClock();
 
-            process_manager = new ProcessManager(min_ins, max_ins, num_cpu, scheduler, delays_per_exec, quantum_cycles, cpu_clock, max_overall_mem, mem_per_frame, mem_per_proc);
+            process_manager = new ProcessManager(min_ins, max_ins, num_cpu, scheduler, delays_per_exec, quantum_cycles, cpu_clock, max_overall_mem, mem_per_frame, mem_per_proc, creation_threads);
             GLOBAL_PM = process_manager;
 
+            if (has_seed)
+            {
+                process_manager->setGlobalSeed(seed);
+                std::cout << "Deterministic seed: " << seed << std::endl;
+            }
+
+            if (fuse_instructions)
+            {
+                process_manager->setFuseInstructions(true);
+                std::cout << "Fusing DECLARE, DECLARE, ADD/SUBTRACT into superinstructions" << std::endl;
+            }
+
+            if (program_templates > 0)
+            {
+                process_manager->setProgramTemplates(program_templates);
+                std::cout << "Processes share " << program_templates << " template programs" << std::endl;
+            }
+
+            if (!trace_file.empty())
+            {
+                process_manager->getScheduler()->setTraceFile(trace_file);
+                std::cout << "Recording scheduler trace to " << trace_file << std::endl;
+            }
+
+            if (!replay_file.empty() && process_manager->getScheduler()->loadReplay(replay_file))
+            {
+                std::cout << "Replaying " << process_manager->getScheduler()->getTrace().getReplayLength()
+                    << " dispatches from " << replay_file << std::endl;
+            }
+
+            if (has_switch_costs)
+            {
+                process_manager->getScheduler()->setSwitchCosts(switch_cost_same_process, switch_cost_same_core, switch_cost_migration);
+            }
+            process_manager->getScheduler()->setInstructionsPerTick(instructions_per_tick);
+            process_manager->getScheduler()->setWorkerCpus(ThreadAffinity::parseCpuList(worker_cpus));
+            if (execution_mode == "coroutine")
+            {
+                process_manager->getScheduler()->setCoroutineMode(true);
+                std::cout << "Execution mode: coroutine" << std::endl;
+            }
+            else if (execution_mode == "pool")
+            {
+                process_manager->getScheduler()->setWorkerPool(worker_threads, tick_lockstep);
+                std::cout << "Execution mode: " << num_cpu << " virtual cores on "
+                    << process_manager->getScheduler()->getWorkerPoolSize() << " worker threads" << std::endl;
+            }
+            else if (execution_mode == "pdes")
+            {
+                process_manager->getScheduler()->setPDES(worker_threads, lookahead_ticks);
+                std::cout << "Execution mode: " << num_cpu << " virtual cores on "
+                    << process_manager->getScheduler()->getWorkerPoolSize() << " worker threads, conservative PDES with "
+                    << process_manager->getScheduler()->getLookahead() << " ticks lookahead" << std::endl;
+            }
+
+            if (batch_arithmetic && (execution_mode == "pool" || execution_mode == "pdes"))
+            {
+                if (instructions_per_tick > 1)
+                {
+                    // A staged ADD/SUBTRACT ends the core's tick, which would
+                    // quietly cap the other setting at one instruction
+                    std::cerr << "[WARNING] batch-arithmetic requires instructions-per-tick 1; batching disabled." << std::endl;
+                }
+                else
+                {
+                    process_manager->getScheduler()->setBatchedArithmetic(true);
+                    std::cout << "Batched ADD/SUBTRACT across cores" << std::endl;
+                }
+            }
+
+            if (scheduler == "mlfq")
+            {
+                process_manager->getScheduler()->setMLFQ(mlfq_quanta, mlfq_boost_ticks);
+            }
+            else if (scheduler == "rr")
+            {
+                if (affinity_window > 0 || affinity_pinning)
+                {
+                    process_manager->getScheduler()->setAffinity(affinity_window, affinity_pinning);
+                }
+
+                if (adaptive_quantum)
+                {
+                    // Without an explicit ceiling allow up to 8x the configured quantum
+                    int ceiling = quantum_max > 0 ? quantum_max : quantum_cycles * 8;
+                    process_manager->getScheduler()->setAdaptiveQuantum(quantum_min, ceiling, quantum_adapt_ticks);
+                    std::cout << "Adaptive quantum: " << quantum_min << "-" << ceiling << " cycles" << std::endl;
+                }
+            }
+            else if ((scheduler == "sjf" || scheduler == "srtf") && aging_rate > 0)
+            {
+                process_manager->getScheduler()->setAgingRate(aging_rate);
+            }
+
+            process_manager->start();
+
+            if (clock_cpu >= 0 || clock_realtime || !worker_cpus.empty())
+            {
+                printAffinity();
+            }
+
             initialized = true;
 
         }
@@ -96,13 +314,30 @@ void ConsoleManager::getInput(const std::string& command)
     }
     else if (command.rfind("screen -s ", 0) == 0)
     {
+        // screen -s <name> [-d <deadline ticks after arrival>]
         std::string name = command.substr(10);
-        createSession(name);
+        int deadline_offset = -1;
+        size_t deadline_pos = name.find(" -d ");
+        if (deadline_pos != std::string::npos)
+        {
+            try
+            {
+                deadline_offset = std::stoi(name.substr(deadline_pos + 4));
+            }
+            catch (const std::exception&)
+            {
+                std::cout << "[ERROR] Invalid deadline. Usage: screen -s <name> -d <ticks>\n";
+                return;
+            }
+            name = name.substr(0, deadline_pos);
+        }
+        createSession(name, deadline_offset);
     }
     else if (command.rfind("screen -r ", 0) == 0)
     {
         std::string name = command.substr(10);
         std::shared_ptr<Process> process = process_manager->getProcess(name);
+        ProcessRecord record;
 
         if (process != nullptr)
         {
@@ -116,6 +351,11 @@ void ConsoleManager::getInput(const std::string& command)
                 std::cout << "Process " << name << " not found." << std::endl;
             }
         }
+        else if (process_manager->getFinishedProcess(name, record))
+        {
+            system("cls");
+            screen_manager.displayFinishedScreen(record);
+        }
         else
         {
             std::cout << "Process " << name << " not found." << std::endl;
@@ -128,7 +368,9 @@ void ConsoleManager::getInput(const std::string& command)
     else if (command == "report-util")
     {
         std::stringstream output;
-        screen_manager.displayAllProcessToStream(process_manager->getAllProcess(), num_cpu, output);
+        screen_manager.displayAllProcessToStream(process_manager->getAllProcess(), *process_manager, num_cpu, output);
+        output << "\n";
+        process_manager->schedStats(output);
 
         std::string filename = "csopesy-log.txt";
         std::filesystem::path filepath = std::filesystem::current_path() / filename;
@@ -154,28 +396,48 @@ void ConsoleManager::getInput(const std::string& command)
 
             scheduler_thread = std::thread([this]()
             {
-                int tick_counter = 0;
-                std::unique_lock<std::mutex> lock(cpu_clock->getMutex(), std::defer_lock);
+                ProcessCreationPipeline& pipeline = process_manager->getCreationPipeline();
+                pipeline.start(static_cast<int>(screens.size()));
+
+                int batch_freq = batch_process_freq > 0 ? batch_process_freq : 1;
+                int last_clock = cpu_clock->getCpuClock();
+                int next_arrival = last_clock + batch_freq;
+                std::deque<int> due_arrivals;
 
                 while (scheduler_running)
                 {
-                    lock.lock();
-                    cpu_clock->getCondition().wait(lock);
-                    lock.unlock();
+                    last_clock = cpu_clock->waitForTick(last_clock);
 
-                    tick_counter++;
-                    if (tick_counter >= batch_process_freq)
+                    // Arrivals are due on fixed tick boundaries, so ticks that pass
+                    // while this thread is busy still produce their processes.
+                    while (next_arrival <= last_clock)
                     {
-                        tick_counter = 0;
-                    	std::string name = "process" + std::to_string(screens.size());
-                        generateSession(name);
+                        due_arrivals.push_back(next_arrival);
+                        next_arrival += batch_freq;
                     }
 
-                    if (screens.size() > 4)
+                    while (!due_arrivals.empty())
                     {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                        std::shared_ptr<Process> process = pipeline.take();
+                        if (!process)
+                        {
+                            break;
+                        }
+
+                        // A screen took the name after the process was built;
+                        // keep its pid and arrival slot under a fresh name
+                        while (screens.find(process->getName()) != screens.end())
+                        {
+                            process = pipeline.rebuild(process);
+                        }
+
+                        generateSession(process);
+                        pipeline.recordArrival(due_arrivals.front(), cpu_clock->getCpuClock());
+                        due_arrivals.pop_front();
                     }
                 }
+
+                pipeline.stop();
             });
         }
         else
@@ -201,6 +463,37 @@ void ConsoleManager::getInput(const std::string& command)
             std::cout << "[ERROR] \"scheduler-start\" is not running.\n";
         }
     }
+    else if (command.rfind("core-add", 0) == 0 || command.rfind("core-remove", 0) == 0)
+    {
+        // core-add [count] / core-remove [count]
+        bool adding = command.rfind("core-add", 0) == 0;
+        std::string count_str = command.substr(adding ? 8 : 11);
+        int count = 1;
+
+        if (!count_str.empty())
+        {
+            try
+            {
+                count = std::stoi(count_str);
+            }
+            catch (...)
+            {
+                count = 0;
+            }
+        }
+
+        if (count < 1)
+        {
+            std::cout << "[ERROR] Usage: " << (adding ? "core-add" : "core-remove") << " [count]\n";
+        }
+        else
+        {
+            // At least one core always stays online
+            Scheduler* scheduler = process_manager->getScheduler();
+            num_cpu = adding ? scheduler->addCores(count) : scheduler->removeCores(count);
+            std::cout << "Cores online: " << num_cpu << "\n";
+        }
+    }
     else if (command == "process-smi")
     {
         process_manager->processSmi();
@@ -209,6 +502,10 @@ void ConsoleManager::getInput(const std::string& command)
     {
         process_manager->vmStat();
     }
+    else if (command == "sched-stats")
+    {
+        process_manager->schedStats(std::cout);
+    }
     else if (command == "clear")
     {
         system("cls");
@@ -229,9 +526,6 @@ void ConsoleManager::getInput(const std::string& command)
             std::cout << "Scheduler stopped by exit.\n";
         }
 
-        if (cpu_clock)
-            cpu_clock->stopCpuClock();
-
     }
     else
     {
@@ -240,16 +534,18 @@ void ConsoleManager::getInput(const std::string& command)
 }
 
 ConsoleManager::~ConsoleManager() {
+    // Core workers wait on clock ticks, so the scheduler has to be stopped
+    // while the clock is still running.
+    if (process_manager) {
+        delete process_manager;
+        process_manager = nullptr;
+    }
+
     if (cpu_clock) {
         cpu_clock->stopCpuClock();
         delete cpu_clock;
         cpu_clock = nullptr;
     }
 
-    if (process_manager) {
-        delete process_manager;
-        process_manager = nullptr;
-    }
-
     std::cout << "ConsoleManager shutting down...\n";
 }
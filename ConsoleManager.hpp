@@ -10,6 +10,7 @@
 #include <iostream>
 #include <fstream>
 #include <mutex>
+#include <vector>
 
 class ConsoleManager
 {
@@ -21,6 +22,37 @@ private:
     int min_ins = 0;
     int max_ins = 0;
     int delays_per_exec = 0;
+    int creation_threads = 2;
+    bool has_seed = false;
+    uint32_t seed = 0;
+    std::string trace_file = "";
+    std::string replay_file = "";
+    std::vector<int> mlfq_quanta;
+    int mlfq_boost_ticks = 100;
+    double aging_rate = 0.0;
+    int batch_deadline = -1;
+    int affinity_window = 0;
+    bool affinity_pinning = false;
+    int switch_cost_same_process = 0;
+    int switch_cost_same_core = 2;
+    int switch_cost_migration = 4;
+    bool has_switch_costs = false;
+    bool adaptive_quantum = false;
+    int quantum_min = 1;
+    int quantum_max = 0;
+    int quantum_adapt_ticks = 100;
+    int instructions_per_tick = 1;
+    std::string execution_mode = "thread";
+    int worker_threads = 0;
+    bool tick_lockstep = false;
+    int lookahead_ticks = 8;
+    bool batch_arithmetic = false;
+    bool fuse_instructions = false;
+    int program_templates = 0;
+    int tick_period_us = 1000;
+    std::string worker_cpus;
+    int clock_cpu = -1;
+    bool clock_realtime = false;
     bool initialized = false;
     bool scheduler_running = false;
     Clock* cpu_clock;
@@ -42,8 +74,10 @@ private:
 
 public:
     ~ConsoleManager();
-    void createSession(const std::string& name);
-    void generateSession(const std::string& name);
+    void createSession(const std::string& name, int deadline_offset = -1);
+    void generateSession(std::shared_ptr<Process> process);
+    void loadConfig(std::ifstream& config_file);
+    void printAffinity();
     void displayAllScreens();
     void getInput(const std::string& command);
 };
@@ -1,5 +1,8 @@
 #include "ConsoleScreen.hpp"
 #include "CoreStateManager.hpp"
+#include "ProcessManager.hpp"
+
+#include <fstream>
 
 void ConsoleScreen::displayHeader()
 {
@@ -15,17 +18,17 @@ void ConsoleScreen::displayHeader()
     << std::endl;
 }
 
-void ConsoleScreen::displayAllProcess(std::map<std::string, std::shared_ptr<Process>> process_list, int num_cpu)
+void ConsoleScreen::displayAllProcess(std::map<std::string, std::shared_ptr<Process>> process_list, ProcessManager& process_manager, int num_cpu)
 {
-    displayAllProcessToStream(process_list, num_cpu, std::cout);
+    displayAllProcessToStream(process_list, process_manager, num_cpu, std::cout);
 }
 
-void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_ptr<Process>> process_list, int num_cpu, std::ostream& out)
+void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_ptr<Process>> process_list, ProcessManager& process_manager, int num_cpu, std::ostream& out)
 {
     static std::mutex process_list_mutex;
     std::lock_guard<std::mutex> lock(process_list_mutex);
 
-    if (process_list.empty())
+    if (process_list.empty() && process_manager.getFinishedCount() == 0)
     {
         out << "No screens available." << std::endl;
         return;
@@ -36,8 +39,8 @@ void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_
     std::stringstream finished;
     int core_usage = 0;
 
-    const std::vector<std::string>& running_processes = CoreStateManager::getInstance().getProcess();
-    const std::vector<int>& core_states = CoreStateManager::getInstance().getCoreStates();
+    std::vector<std::string> running_processes = CoreStateManager::getInstance().getProcess();
+    std::vector<int> core_states = CoreStateManager::getInstance().getCoreStates();
 
     for (int core_state : core_states)
     {
@@ -56,6 +59,32 @@ void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_
             return a->getCreationTime() < b->getCreationTime();
         });
 
+    // Archived records are formatted in place under the manager's lock;
+    // finished processes still in the live list have not been archived yet
+    // and are shown alongside them.
+    std::vector<std::pair<std::chrono::time_point<std::chrono::system_clock>, std::string>> finished_lines;
+    auto addFinished = [&finished_lines](const ProcessRecord& record)
+        {
+            std::stringstream line;
+            line << std::left << std::setw(13) << record.name
+                << " (" << record.time << ") "
+                << "  FINISHED " << "   "
+                << record.command_counter << " / "
+                << record.lines_of_code << std::endl;
+            finished_lines.emplace_back(record.creation_time, line.str());
+        };
+    process_manager.forEachFinishedProcess(addFinished);
+    for (const auto& process : sorted_processes)
+    {
+        if (process->getState() == Process::FINISHED)
+            addFinished(process->createRecord());
+    }
+
+    std::sort(finished_lines.begin(), finished_lines.end(),
+        [](const auto& a, const auto& b) {
+            return a.first < b.first;
+        });
+
     out << "\nExisting Screens:" << std::endl;
     for (const auto& process : sorted_processes)
     {
@@ -70,13 +99,11 @@ void ConsoleScreen::displayAllProcessToStream(std::map<std::string, std::shared_
                 << process->getLinesOfCode() << std::endl;
             running << temp.str();
         }
-        else if (process->getState() == Process::FINISHED)
-        {
-            temp << "  FINISHED " << "   "
-                << process->getCommandCounter() << " / "
-                << process->getLinesOfCode() << std::endl;
-            finished << temp.str();
-        }
+    }
+
+    for (const auto& line : finished_lines)
+    {
+        finished << line.second;
     }
 
     out << "CPU utilization: " << (static_cast<double>(core_usage) / num_cpu) * 100 << "%\n";
@@ -103,6 +130,7 @@ void ConsoleScreen::displayUpdatedProcess(std::shared_ptr<Process> process)
 
         std::cout << "Current instruction line: " << process->getCommandCounter() << std::endl;
         std::cout << "Lines of code: " << process->getLinesOfCode() << std::endl;
+        std::cout << "Core migrations: " << process->getMigrationCount() << std::endl;
         std::cout << std::endl;
     }
     else
@@ -146,6 +174,48 @@ void ConsoleScreen::displayScreen(std::shared_ptr<Process> process)
     }
 }
 
+void ConsoleScreen::displayFinishedScreen(const ProcessRecord& record)
+{
+    std::cout << "Screen: " << record.name << std::endl;
+    std::cout << "Instruction: Line " << record.command_counter << " / "
+              << record.lines_of_code << std::endl;
+    std::cout << "Created at: " << record.time << std::endl;
+    std::cout << "Type 'exit' to return to the main menu." << std::endl;
+
+    std::string command;
+    while (true)
+    {
+        std::cout << "Enter a command: ";
+        std::getline(std::cin, command);
+        if (command == "process-smi")
+        {
+            std::cout << "Process Name: " << record.name << std::endl;
+            std::cout << "ID: " << record.final_core << std::endl;
+            std::cout << "Logs: \n";
+
+            std::ifstream log_file(record.log_path);
+            std::string line;
+            while (std::getline(log_file, line))
+            {
+                std::cout << line << std::endl;
+            }
+
+            std::cout << "Finished!" << std::endl;
+            std::cout << std::endl;
+        }
+        else if (command == "exit")
+        {
+            system("cls");
+            displayHeader();
+            break;
+        }
+        else
+        {
+            std::cout << "Unknown command. Please try again." << std::endl;
+        }
+    }
+}
+
 std::string ConsoleScreen::getCurrentTimestamp()
 {
     std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
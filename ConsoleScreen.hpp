@@ -2,8 +2,10 @@
 #define CONSOLE_SCREEN_H
 
 #include "Process.hpp"
+#include "ProcessRecord.hpp"
 
 #include <map>
+#include <vector>
 #include <memory>
 #include <string>
 #include <iomanip>
@@ -11,14 +13,17 @@
 #include <iostream>
 #include <mutex>
 
+class ProcessManager;
+
 class ConsoleScreen
 {
 public:
     void displayHeader();
-    void displayAllProcess(std::map<std::string, std::shared_ptr<Process>> process_list, int num_cpu);
+    void displayAllProcess(std::map<std::string, std::shared_ptr<Process>> process_list, ProcessManager& process_manager, int num_cpu);
     void displayUpdatedProcess(std::shared_ptr<Process> process);
     void displayScreen(std::shared_ptr<Process> process);
-    void displayAllProcessToStream(std::map<std::string, std::shared_ptr<Process>> process_list, int num_cpu, std::ostream& out);
+    void displayFinishedScreen(const ProcessRecord& record);
+    void displayAllProcessToStream(std::map<std::string, std::shared_ptr<Process>> process_list, ProcessManager& process_manager, int num_cpu, std::ostream& out);
     std::string getCurrentTimestamp();
     std::chrono::time_point<std::chrono::system_clock> getCreationTime();
     std::mutex process_list_mutex;
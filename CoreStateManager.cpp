@@ -38,20 +38,15 @@ int CoreStateManager::getCoreState(int core_id)
     }
 }
 
-const std::vector<std::string>& CoreStateManager::getProcess() const
+std::vector<std::string> CoreStateManager::getProcess() const
 {
     std::lock_guard<std::mutex> lock(core_states_mutex);
     return process_names;
 }
 
-const std::vector<int>& CoreStateManager::getCoreStates() const
+std::vector<int> CoreStateManager::getCoreStates() const
 {
     std::lock_guard<std::mutex> lock(core_states_mutex);
-    if (core_states.empty())
-    {
-        static std::vector<int> empty_vec;
-        return empty_vec;
-    }
     return core_states;
 }
 
@@ -11,9 +11,10 @@ public:
     static CoreStateManager& getInstance();
     void setCoreState(int core_id, int state, std::string process_name);
     int getCoreState(int core_id);
-    const std::vector<int>& getCoreStates() const;
+    // Copies taken under the lock; removeCores() may resize the vectors
+    std::vector<int> getCoreStates() const;
     void initialize(int num_core);
-    const std::vector<std::string>& getProcess() const;
+    std::vector<std::string> getProcess() const;
 
 private:
     CoreStateManager() = default;
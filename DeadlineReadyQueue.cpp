@@ -0,0 +1,92 @@
+#include "DeadlineReadyQueue.hpp"
+
+#include <algorithm>
+#include <limits>
+
+DeadlineReadyQueue::DeadlineReadyQueue(int quantum_cycle)
+    : quantum_cycle(quantum_cycle), next_sequence(0)
+{
+}
+
+bool DeadlineReadyQueue::compare(const Entry& a, const Entry& b)
+{
+    // std heap functions build a max-heap; invert so the earliest deadline is on top
+    if (a.deadline != b.deadline)
+    {
+        return a.deadline > b.deadline;
+    }
+    return a.sequence > b.sequence;
+}
+
+void DeadlineReadyQueue::push(std::shared_ptr<Process> process)
+{
+    long long deadline = process->hasDeadline() ? process->getDeadlineTick() : std::numeric_limits<long long>::max();
+    heap.push_back({ deadline, next_sequence++, process });
+    std::push_heap(heap.begin(), heap.end(), compare);
+}
+
+void DeadlineReadyQueue::requeue(std::shared_ptr<Process> process, bool)
+{
+    push(process);
+}
+
+std::shared_ptr<Process> DeadlineReadyQueue::pop(int)
+{
+    if (heap.empty())
+    {
+        return nullptr;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), compare);
+    std::shared_ptr<Process> process = heap.back().process;
+    heap.pop_back();
+    return process;
+}
+
+std::shared_ptr<Process> DeadlineReadyQueue::remove(size_t pid)
+{
+    auto it = std::find_if(heap.begin(), heap.end(), [pid](const Entry& entry)
+        {
+            return entry.process->getPID() == pid;
+        });
+
+    if (it == heap.end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Process> process = it->process;
+    heap.erase(it);
+    std::make_heap(heap.begin(), heap.end(), compare);
+    return process;
+}
+
+bool DeadlineReadyQueue::empty() const
+{
+    return heap.empty();
+}
+
+size_t DeadlineReadyQueue::size() const
+{
+    return heap.size();
+}
+
+void DeadlineReadyQueue::clear()
+{
+    heap.clear();
+}
+
+int DeadlineReadyQueue::getQuantum(const std::shared_ptr<Process>&) const
+{
+    return quantum_cycle;
+}
+
+void DeadlineReadyQueue::setQuantum(int quantum_cycle)
+{
+    this->quantum_cycle = quantum_cycle;
+}
+
+std::vector<size_t> DeadlineReadyQueue::getLevelSizes() const
+{
+    return { heap.size() };
+}
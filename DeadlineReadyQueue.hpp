@@ -0,0 +1,39 @@
+#ifndef DEADLINE_READY_QUEUE_H
+#define DEADLINE_READY_QUEUE_H
+
+#include "IReadyQueue.hpp"
+#include <cstdint>
+
+// Binary min-heap keyed on absolute deadline tick, used by "edf".
+// Processes without a deadline sort after every process that has one, in arrival order.
+class DeadlineReadyQueue : public IReadyQueue
+{
+public:
+    DeadlineReadyQueue(int quantum_cycle);
+    void push(std::shared_ptr<Process> process) override;
+    void requeue(std::shared_ptr<Process> process, bool used_full_quantum) override;
+    std::shared_ptr<Process> pop(int core_id) override;
+    std::shared_ptr<Process> remove(size_t pid) override;
+    bool empty() const override;
+    size_t size() const override;
+    void clear() override;
+    int getQuantum(const std::shared_ptr<Process>& process) const override;
+    std::vector<size_t> getLevelSizes() const override;
+    void setQuantum(int quantum_cycle) override;
+
+private:
+    struct Entry
+    {
+        long long deadline;
+        uint64_t sequence;
+        std::shared_ptr<Process> process;
+    };
+
+    static bool compare(const Entry& a, const Entry& b);
+
+    int quantum_cycle;
+    uint64_t next_sequence;
+    std::vector<Entry> heap;
+};
+
+#endif
@@ -6,6 +6,7 @@
 
 #include <ctime>
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -16,48 +17,39 @@ class DeclareCommand : public ICommand
 {
 
 public:
-    DeclareCommand(int pid, int core, std::string name, SymbolTable& table,
-        const std::string& varName, uint16_t value,
-        std::vector<std::string>* logList)
-        : ICommand(pid, CommandType::DECLARE), core_(core), table_(table),
-        varName(varName), name_(name), log_list_(logList)
+    DeclareCommand(std::string_view varName, uint16_t value)
+        : ICommand(CommandType::DECLARE), varName(varName), value_(value)
     {
-        st = ST(ST::DataType::UINT16, std::to_string(value));
     }
 
-    void execute() override
+    void execute(ExecutionContext& context) const override
     {
-        table_.insert(varName, st);
+        context.symbol_table->store(varName, value_);
 
         std::ostringstream oss;
-        oss << getCurrentTimestamp() << " Core:" << core_;
+        oss << getCurrentTimestamp() << " Core:" << context.core;
         if (sub_level_ > 0) oss << " [SUBCOMMAND-" << sub_level_ << "]";
-        oss << " \"Inserted to the Symbol table: " << varName << " " << st.value << "\"";
+        oss << " \"Inserted to the Symbol table: " << varName << " " << value_ << "\"";
         std::string log_line = oss.str();
 
-        std::ofstream outfile(name_ + ".txt", std::ios::app);
+        std::ofstream outfile(std::string(context.name) + ".txt", std::ios::app);
         outfile << log_line << std::endl;
         outfile.close();
 
-        if (log_list_)
-            log_list_->push_back(log_line);
+        if (context.log_list)
+            context.log_list->push_back(log_line);
     }
 
-
-    void setCore(int core) override
+    std::string_view getVarName() const
     {
-        core_ = core;
+        return varName;
     }
 
 private:
-    int core_;
-    std::string varName;
-    ST st;
-    std::string name_;
-    SymbolTable& table_;
-	std::vector<std::string>* log_list_;
+    std::string_view varName;
+    uint16_t value_;
 
-    std::string getCurrentTimestamp()
+    std::string getCurrentTimestamp() const
     {
         auto now = std::chrono::system_clock::now();
         std::time_t time_now = std::chrono::system_clock::to_time_t(now);
@@ -0,0 +1,38 @@
+#ifndef END_FOR_COMMAND_H
+#define END_FOR_COMMAND_H
+
+#include "ICommand.hpp"
+#include "ForCommand.hpp"
+
+// Back-edge of a lowered FOR loop. While its head has iterations left the
+// process jumps back to the head, jump_offset slots earlier; otherwise it
+// resets the head and falls through. The outcome is left in the context's
+// branch_taken. Writes no log line.
+class EndForCommand : public ICommand
+{
+public:
+    EndForCommand(const ForCommand* head, int jump_offset)
+        : ICommand(CommandType::END_FOR), head_(head), jump_offset_(jump_offset)
+    {
+    }
+
+    void execute(ExecutionContext& context) const override
+    {
+        context.branch_taken = head_->hasMoreIterations(context);
+        if (!context.branch_taken)
+        {
+            head_->reset(context);
+        }
+    }
+
+    int getJumpOffset() const
+    {
+        return jump_offset_;
+    }
+
+private:
+    const ForCommand* head_;
+    int jump_offset_;
+};
+
+#endif
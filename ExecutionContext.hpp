@@ -0,0 +1,33 @@
+#ifndef EXECUTION_CONTEXT_H
+#define EXECUTION_CONTEXT_H
+
+#include "SymbolTable.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Per-process state an instruction executes against. Commands in a
+// ProgramImage are immutable and may be shared by many processes, so
+// everything that differs between runs of the same program lives here.
+struct ExecutionContext
+{
+    int pid = 0;
+    int core = -1;
+    // Process name; names the log file and appears in the PRINT greeting
+    std::string_view name;
+    SymbolTable* symbol_table = nullptr;
+    std::vector<std::string>* log_list = nullptr;
+    // One counter per FOR loop in the current chunk, indexed by loop id
+    std::vector<int> loop_iterations;
+    // Outcome of the last END_FOR
+    bool branch_taken = false;
+    // Set by SLEEP; the process goes to WAITING for this many ticks
+    uint8_t sleep_ticks = 0;
+    // ADD/SUBTRACT operands, read by gather() and logged by commit()
+    int lhs = 0;
+    int rhs = 0;
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "FIFOReadyQueue.hpp"
+
+#include <algorithm>
+
+FIFOReadyQueue::FIFOReadyQueue(int quantum_cycle, int affinity_window, bool hard_pinning)
+    : quantum_cycle(quantum_cycle), affinity_window(affinity_window), hard_pinning(hard_pinning)
+{
+}
+
+void FIFOReadyQueue::push(std::shared_ptr<Process> process)
+{
+    process_queue.push_back(process);
+}
+
+void FIFOReadyQueue::requeue(std::shared_ptr<Process> process, bool)
+{
+    process_queue.push_back(process);
+}
+
+std::shared_ptr<Process> FIFOReadyQueue::pop(int core_id)
+{
+    if (process_queue.empty())
+    {
+        return nullptr;
+    }
+
+    auto it = process_queue.begin();
+
+    if (hard_pinning)
+    {
+        // A process stays on the first core it ran on
+        it = std::find_if(process_queue.begin(), process_queue.end(), [core_id](const std::shared_ptr<Process>& p)
+            {
+                return p->getCPUCoreID() == core_id || p->getCPUCoreID() < 1;
+            });
+
+        if (it == process_queue.end())
+        {
+            return nullptr;
+        }
+    }
+    else if (affinity_window > 0)
+    {
+        // Prefer a process that last ran here, but only look a few entries
+        // past the head so nothing waits much longer than under plain FIFO.
+        auto window_end = process_queue.begin() + std::min<size_t>(affinity_window, process_queue.size());
+        auto warm = std::find_if(process_queue.begin(), window_end, [core_id](const std::shared_ptr<Process>& p)
+            {
+                return p->getCPUCoreID() == core_id;
+            });
+
+        if (warm != window_end)
+        {
+            it = warm;
+        }
+    }
+
+    std::shared_ptr<Process> process = *it;
+    process_queue.erase(it);
+    return process;
+}
+
+std::shared_ptr<Process> FIFOReadyQueue::remove(size_t pid)
+{
+    auto it = std::find_if(process_queue.begin(), process_queue.end(), [pid](const std::shared_ptr<Process>& p)
+        {
+            return p->getPID() == pid;
+        });
+
+    if (it == process_queue.end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Process> process = *it;
+    process_queue.erase(it);
+    return process;
+}
+
+bool FIFOReadyQueue::empty() const
+{
+    return process_queue.empty();
+}
+
+size_t FIFOReadyQueue::size() const
+{
+    return process_queue.size();
+}
+
+void FIFOReadyQueue::clear()
+{
+    process_queue.clear();
+}
+
+int FIFOReadyQueue::getQuantum(const std::shared_ptr<Process>&) const
+{
+    return quantum_cycle;
+}
+
+void FIFOReadyQueue::setQuantum(int quantum_cycle)
+{
+    this->quantum_cycle = quantum_cycle;
+}
+
+std::vector<size_t> FIFOReadyQueue::getLevelSizes() const
+{
+    return { process_queue.size() };
+}
+
+
+void FIFOReadyQueue::onCoreRetired(int core_id)
+{
+    // Release processes pinned to a core that no longer exists
+    for (auto& process : process_queue)
+    {
+        if (process->getCPUCoreID() == core_id)
+        {
+            process->setCPUCoreID(-1);
+        }
+    }
+}
\ No newline at end of file
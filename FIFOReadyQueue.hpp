@@ -0,0 +1,30 @@
+#ifndef FIFO_READY_QUEUE_H
+#define FIFO_READY_QUEUE_H
+
+#include "IReadyQueue.hpp"
+#include <deque>
+
+class FIFOReadyQueue : public IReadyQueue
+{
+public:
+    FIFOReadyQueue(int quantum_cycle, int affinity_window = 0, bool hard_pinning = false);
+    void push(std::shared_ptr<Process> process) override;
+    void requeue(std::shared_ptr<Process> process, bool used_full_quantum) override;
+    std::shared_ptr<Process> pop(int core_id) override;
+    std::shared_ptr<Process> remove(size_t pid) override;
+    bool empty() const override;
+    size_t size() const override;
+    void clear() override;
+    int getQuantum(const std::shared_ptr<Process>& process) const override;
+    std::vector<size_t> getLevelSizes() const override;
+    void setQuantum(int quantum_cycle) override;
+    void onCoreRetired(int core_id) override;
+
+private:
+    int quantum_cycle;
+    int affinity_window;
+    bool hard_pinning;
+    std::deque<std::shared_ptr<Process>> process_queue;
+};
+
+#endif
@@ -5,73 +5,66 @@
 #include <vector>
 #include <memory>
 #include <string>
-#include <stdexcept>
-#include <thread>
-
+#include <string_view>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <ctime>
+
+// Loop-counter op at the head of a lowered FOR loop. Program generation
+// flattens a loop into this head, the body and an EndForCommand back-edge,
+// so every body instruction is dispatched and counted on its own. The head
+// runs once per iteration and logs it; the counter itself lives in the
+// process's ExecutionContext under loop_id, numbered within the chunk.
 class ForCommand : public ICommand
 {
 public:
-    ForCommand(int pid, int core, const std::string& name, const std::vector<std::shared_ptr<ICommand>>& instructions, int repeats, std::vector<std::string>* log_list)
-        : ICommand(pid, CommandType::FOR), core_(core),  name_(name), instructions_(instructions), repeats_(repeats), log_list_(log_list)
+    ForCommand(int repeats, int loop_id)
+        : ICommand(CommandType::FOR), repeats_(repeats), loop_id_(loop_id)
     {
     }
 
-    void execute() override
+    void execute(ExecutionContext& context) const override
     {
-        if (GLOBAL_SHUTTING_DOWN)
-            return;
-
-        static thread_local int current_depth = 0;
-
-        if (current_depth >= 3)
-        {
-            std::cerr << "Max FOR nesting depth (3) reached for PID: " << pid_ << std::endl;
-            return;
-        }
-
-        ++current_depth;
-
-        for (int i = 0; i < repeats_; ++i)
-        {
-            if (GLOBAL_SHUTTING_DOWN) break;
+        int iteration = ++context.loop_iterations[loop_id_];
 
-            std::ostringstream oss;
-            oss << getCurrentTimestamp()
-            << " Core:" << core_
-            << " \"FOR loop iteration " << (i + 1) << " of " << repeats_ << "\"";
+        std::ostringstream oss;
+        oss << getCurrentTimestamp()
+            << " Core:" << context.core
+            << " \"FOR loop iteration " << iteration << " of " << repeats_ << "\"";
 
-            std::string log_line = oss.str();
+        std::string log_line = oss.str();
 
-            std::ofstream outfile(name_ + ".txt", std::ios::app);
-            outfile << log_line << std::endl;
-            outfile.close();
+        std::ofstream outfile(std::string(context.name) + ".txt", std::ios::app);
+        outfile << log_line << std::endl;
+        outfile.close();
 
-            if (log_list_) log_list_->push_back(log_line);
+        if (context.log_list) context.log_list->push_back(log_line);
+    }
 
-            for (auto& cmd : instructions_)
-            {
-                cmd->setCore(core_);
-                cmd->setSubcommandLevel(current_depth);
-                cmd->execute();
-            }
-        }
+    // Called by the back-edge once the last iteration is done, so an
+    // enclosing loop re-enters this one from the first iteration
+    void reset(ExecutionContext& context) const
+    {
+        context.loop_iterations[loop_id_] = 0;
+    }
 
-        --current_depth;
+    bool hasMoreIterations(const ExecutionContext& context) const
+    {
+        return context.loop_iterations[loop_id_] < repeats_;
     }
 
-    void setCore(int core) override
+    int getRepeats() const
     {
-        core_ = core;
+        return repeats_;
     }
 
 private:
-    int core_;
     int repeats_;
-    std::string name_;
-    std::vector<std::shared_ptr<ICommand>> instructions_;
-    std::vector<std::string>* log_list_;
+    int loop_id_;
 
-    std::string getCurrentTimestamp()
+    std::string getCurrentTimestamp() const
     {
         auto now = std::chrono::system_clock::now();
         std::time_t time_now = std::chrono::system_clock::to_time_t(now);
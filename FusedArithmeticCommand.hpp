@@ -0,0 +1,34 @@
+#ifndef FUSED_ARITHMETIC_COMMAND_H
+#define FUSED_ARITHMETIC_COMMAND_H
+
+#include "ICommand.hpp"
+
+// Superinstruction for the generated DECLARE, DECLARE, ADD/SUBTRACT
+// triple. One dispatch runs all three original commands, so the symbol
+// table and the three log lines are exactly what the unfused program
+// produces; the process advances its instruction counter by LINES.
+class FusedArithmeticCommand : public ICommand
+{
+public:
+    static constexpr int LINES = 3;
+
+    FusedArithmeticCommand(const ICommand* declare_lhs, const ICommand* declare_rhs, const ICommand* arithmetic)
+        : ICommand(CommandType::FUSED), declare_lhs_(declare_lhs),
+        declare_rhs_(declare_rhs), arithmetic_(arithmetic)
+    {
+    }
+
+    void execute(ExecutionContext& context) const override
+    {
+        declare_lhs_->execute(context);
+        declare_rhs_->execute(context);
+        arithmetic_->execute(context);
+    }
+
+private:
+    const ICommand* declare_lhs_;
+    const ICommand* declare_rhs_;
+    const ICommand* arithmetic_;
+};
+
+#endif
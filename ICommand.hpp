@@ -5,6 +5,7 @@
 
 #include <string>
 #include "ST.hpp"
+#include "ExecutionContext.hpp"
 
 class ICommand
 {
@@ -16,22 +17,25 @@ public:
         ADD,
         SUBTRACT,
         SLEEP,
-        FOR
+        FOR,
+        END_FOR,
+        FUSED
     };
 
-    ICommand(int pid, CommandType command_type)
-        : pid_(pid), command_type_(command_type)
+    explicit ICommand(CommandType command_type)
+        : command_type_(command_type)
     {
     }
 
-    virtual void execute() = 0;
-    virtual void setCore(int core) = 0;
+    // Commands are immutable once generated so a ProgramImage can be shared;
+    // all per-process state is read from and written to the context
+    virtual void execute(ExecutionContext& context) const = 0;
     void setSubcommandLevel(int level) { sub_level_ = level; }
     int getSubcommandLevel() const { return sub_level_; }
+    CommandType getCommandType() const { return command_type_; }
 
 
 protected:
-    int pid_;
     CommandType command_type_;
     int sub_level_ = 0;
 
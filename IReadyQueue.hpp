@@ -0,0 +1,30 @@
+#ifndef IREADY_QUEUE_H
+#define IREADY_QUEUE_H
+
+#include <memory>
+#include <vector>
+#include "Process.hpp"
+
+// Ready queue used by the Scheduler. The scheduling policy lives in the
+// queue: which process is handed out next and how long it may run.
+// pop() may return nullptr while the queue is non-empty if nothing in it may
+// run on core_id. Callers hold the scheduler's queue mutex around every call.
+class IReadyQueue
+{
+public:
+    virtual ~IReadyQueue() = default;
+    virtual void push(std::shared_ptr<Process> process) = 0;
+    virtual void requeue(std::shared_ptr<Process> process, bool used_full_quantum) = 0;
+    virtual std::shared_ptr<Process> pop(int core_id) = 0;
+    virtual std::shared_ptr<Process> remove(size_t pid) = 0;
+    virtual bool empty() const = 0;
+    virtual size_t size() const = 0;
+    virtual void clear() = 0;
+    virtual int getQuantum(const std::shared_ptr<Process>& process) const = 0;
+    virtual std::vector<size_t> getLevelSizes() const = 0;
+    virtual void onCoreRetired(int) {}
+    // Queues with per-level quanta keep their own and ignore this
+    virtual void setQuantum(int) {}
+};
+
+#endif
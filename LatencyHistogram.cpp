@@ -0,0 +1,121 @@
+#include "LatencyHistogram.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+LatencyHistogram::LatencyHistogram() : count_(0), max_(0)
+{
+    clear();
+}
+
+int LatencyHistogram::bucketIndex(uint64_t value)
+{
+    // Values below SUB_BUCKETS map one to one; above that the top
+    // SUB_BUCKET_BITS bits below the leading one pick the sub-bucket.
+    if (value < SUB_BUCKETS)
+    {
+        return static_cast<int>(value);
+    }
+
+    int leading_bit = 63;
+    while (!(value & (uint64_t(1) << leading_bit)))
+    {
+        leading_bit--;
+    }
+
+    int exponent = leading_bit - SUB_BUCKET_BITS;
+    int sub_bucket = static_cast<int>((value >> exponent) & (SUB_BUCKETS - 1));
+    return (exponent + 1) * SUB_BUCKETS + sub_bucket;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(int index)
+{
+    if (index < SUB_BUCKETS)
+    {
+        return static_cast<uint64_t>(index);
+    }
+
+    int exponent = index / SUB_BUCKETS - 1;
+    uint64_t sub_bucket = static_cast<uint64_t>(index % SUB_BUCKETS);
+    uint64_t lower = (SUB_BUCKETS | sub_bucket) << exponent;
+    return lower + ((uint64_t(1) << exponent) - 1);
+}
+
+void LatencyHistogram::record(uint64_t value)
+{
+    counts_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t current = max_.load(std::memory_order_relaxed);
+    while (value > current && !max_.compare_exchange_weak(current, value, std::memory_order_relaxed))
+    {
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other)
+{
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        uint64_t count = other.counts_[i].load(std::memory_order_relaxed);
+        if (count > 0)
+        {
+            counts_[i].fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    count_.fetch_add(other.count_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    uint64_t other_max = other.max_.load(std::memory_order_relaxed);
+    if (other_max > max_.load(std::memory_order_relaxed))
+    {
+        max_.store(other_max, std::memory_order_relaxed);
+    }
+}
+
+void LatencyHistogram::clear()
+{
+    for (auto& count : counts_)
+    {
+        count.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getCount() const
+{
+    return count_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getMax() const
+{
+    return max_.load(std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::getPercentile(double percentile) const
+{
+    // Sum the buckets rather than trusting count_, which may be ahead of
+    // them while a core is recording.
+    uint64_t total = 0;
+    for (const auto& count : counts_)
+    {
+        total += count.load(std::memory_order_relaxed);
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(percentile / 100.0 * total));
+    rank = std::max<uint64_t>(rank, 1);
+
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i)
+    {
+        seen += counts_[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+        {
+            return std::min(bucketUpperBound(i), getMax());
+        }
+    }
+    return getMax();
+}
@@ -0,0 +1,36 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Log-linear (HDR-style) histogram: values are grouped by power of two, and
+// each power of two is split into SUB_BUCKETS linear buckets, so a reported
+// percentile is within 1/SUB_BUCKETS of the true value at any magnitude.
+// One core records into its own histogram; readers merge a snapshot.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram();
+    void record(uint64_t value);
+    void merge(const LatencyHistogram& other);
+    void clear();
+    uint64_t getCount() const;
+    uint64_t getMax() const;
+    uint64_t getPercentile(double percentile) const;
+
+private:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+    static constexpr int BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    static int bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(int index);
+
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts_;
+    std::atomic<uint64_t> count_;
+    std::atomic<uint64_t> max_;
+};
+
+#endif
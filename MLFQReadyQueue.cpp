@@ -0,0 +1,135 @@
+#include "MLFQReadyQueue.hpp"
+
+#include <algorithm>
+
+MLFQReadyQueue::MLFQReadyQueue(const std::vector<int>& quanta, int boost_ticks, Clock* cpu_clock)
+    : quanta(quanta), levels(quanta.size()), boost_ticks(boost_ticks), last_boost_tick(cpu_clock->getCpuClock()),
+    boost_epoch(0), n_process(0), cpu_clock(cpu_clock)
+{
+}
+
+void MLFQReadyQueue::push(std::shared_ptr<Process> process)
+{
+    boostIfDue();
+    process->setPriorityLevel(0, boost_epoch);
+    levels[0].push_back(process);
+    n_process++;
+}
+
+void MLFQReadyQueue::requeue(std::shared_ptr<Process> process, bool used_full_quantum)
+{
+    boostIfDue();
+
+    int level = process->getPriorityLevel();
+    if (process->getPriorityEpoch() < boost_epoch)
+    {
+        // Was running when the last boost happened
+        level = 0;
+    }
+    else if (used_full_quantum)
+    {
+        level = std::min(level + 1, static_cast<int>(levels.size()) - 1);
+    }
+
+    process->setPriorityLevel(level, boost_epoch);
+    levels[level].push_back(process);
+    n_process++;
+}
+
+std::shared_ptr<Process> MLFQReadyQueue::pop(int)
+{
+    boostIfDue();
+
+    for (auto& level : levels)
+    {
+        if (!level.empty())
+        {
+            std::shared_ptr<Process> process = level.front();
+            level.pop_front();
+            n_process--;
+            return process;
+        }
+    }
+    return nullptr;
+}
+
+std::shared_ptr<Process> MLFQReadyQueue::remove(size_t pid)
+{
+    for (auto& level : levels)
+    {
+        auto it = std::find_if(level.begin(), level.end(), [pid](const std::shared_ptr<Process>& p)
+            {
+                return p->getPID() == pid;
+            });
+
+        if (it != level.end())
+        {
+            std::shared_ptr<Process> process = *it;
+            level.erase(it);
+            n_process--;
+            return process;
+        }
+    }
+    return nullptr;
+}
+
+bool MLFQReadyQueue::empty() const
+{
+    return n_process == 0;
+}
+
+size_t MLFQReadyQueue::size() const
+{
+    return n_process;
+}
+
+void MLFQReadyQueue::clear()
+{
+    for (auto& level : levels)
+    {
+        level.clear();
+    }
+    n_process = 0;
+}
+
+int MLFQReadyQueue::getQuantum(const std::shared_ptr<Process>& process) const
+{
+    int level = std::min(process->getPriorityLevel(), static_cast<int>(quanta.size()) - 1);
+    return quanta[level];
+}
+
+std::vector<size_t> MLFQReadyQueue::getLevelSizes() const
+{
+    std::vector<size_t> sizes;
+    for (const auto& level : levels)
+    {
+        sizes.push_back(level.size());
+    }
+    return sizes;
+}
+
+void MLFQReadyQueue::boostIfDue()
+{
+    int now = cpu_clock->getCpuClock();
+    if (boost_ticks <= 0 || now - last_boost_tick < boost_ticks)
+    {
+        return;
+    }
+
+    last_boost_tick = now;
+    boost_epoch++;
+
+    for (size_t i = 1; i < levels.size(); ++i)
+    {
+        for (auto& process : levels[i])
+        {
+            levels[0].push_back(process);
+        }
+        levels[i].clear();
+    }
+
+    for (auto& process : levels[0])
+    {
+        process->setPriorityLevel(0, boost_epoch);
+    }
+}
@@ -0,0 +1,38 @@
+#ifndef MLFQ_READY_QUEUE_H
+#define MLFQ_READY_QUEUE_H
+
+#include "IReadyQueue.hpp"
+#include "Clock.hpp"
+#include <deque>
+
+// Multi-level feedback queue: new processes start at level 0, a process that
+// uses its whole quantum drops one level, and every boost_ticks all processes
+// go back to level 0 so long jobs cannot starve. A boost_ticks of 0 turns
+// the boost off.
+class MLFQReadyQueue : public IReadyQueue
+{
+public:
+    MLFQReadyQueue(const std::vector<int>& quanta, int boost_ticks, Clock* cpu_clock);
+    void push(std::shared_ptr<Process> process) override;
+    void requeue(std::shared_ptr<Process> process, bool used_full_quantum) override;
+    std::shared_ptr<Process> pop(int core_id) override;
+    std::shared_ptr<Process> remove(size_t pid) override;
+    bool empty() const override;
+    size_t size() const override;
+    void clear() override;
+    int getQuantum(const std::shared_ptr<Process>& process) const override;
+    std::vector<size_t> getLevelSizes() const override;
+
+private:
+    void boostIfDue();
+
+    std::vector<int> quanta;
+    std::vector<std::deque<std::shared_ptr<Process>>> levels;
+    int boost_ticks;
+    int last_boost_tick;
+    int boost_epoch;
+    size_t n_process;
+    Clock* cpu_clock;
+};
+
+#endif
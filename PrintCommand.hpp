@@ -4,6 +4,7 @@
 #include "ICommand.hpp"
 #include "SymbolTable.hpp"
 #include <string>
+#include <string_view>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
@@ -13,75 +14,59 @@
 class PrintCommand : public ICommand
 {
 public:
-	PrintCommand(int pid, int core, const std::string& to_print, const std::string& name,
-		std::vector<std::string>* log_list)
-		: ICommand(pid, CommandType::PRINT),
-		core_(core),
-		to_print_(to_print),
-		name_(name),
-		log_list_(log_list),
-		dynamic_(false)
+	enum Message
 	{
-	}
-
-	PrintCommand(int pid, int core, const std::string& var_name, const std::string& name,
-		SymbolTable& table, std::vector<std::string>* log_list)
-		: ICommand(pid, CommandType::PRINT),
-		core_(core),
-		var_name_(var_name),
-		name_(name),
-		table_(&table),
-		log_list_(log_list),
-		dynamic_(true)
+		LITERAL,
+		VARIABLE,
+		// "Hello World From <process> started."
+		GREETING
+	};
+
+	// text is the string to print for LITERAL and the symbol name for VARIABLE
+	PrintCommand(Message message, std::string_view text = {})
+		: ICommand(CommandType::PRINT),
+		message_(message),
+		text_(text)
 	{
 	}
 
-	void execute() override
+	void execute(ExecutionContext& context) const override
 	{
 		std::string msg;
 
-		if (dynamic_)
+		if (message_ == VARIABLE)
 		{
-			ST st = table_->fetch(var_name_);
-			msg = "Current " + var_name_ + ": " + st.value;
+			ST st = context.symbol_table->fetch(text_);
+			msg = "Current " + std::string(text_) + ": " + st.text();
+		}
+		else if (message_ == GREETING)
+		{
+			msg = "Hello World From " + std::string(context.name) + " started.";
 		}
 		else
 		{
-			msg = to_print_;
+			msg = std::string(text_);
 		}
 
 		std::ostringstream oss;
-		oss << getCurrentTimestamp() << " Core:" << core_ << " \"" << msg << "\"";
+		oss << getCurrentTimestamp() << " Core:" << context.core << " \"" << msg << "\"";
 		std::string log_line = oss.str();
 
-		std::ofstream outfile(name_ + ".txt", std::ios::app);
+		std::ofstream outfile(std::string(context.name) + ".txt", std::ios::app);
 		outfile << log_line << std::endl;
 		outfile.close();
 
-		if (log_list_)
+		if (context.log_list)
 		{
-			log_list_->push_back(log_line);
+			context.log_list->push_back(log_line);
 		}
 	}
 
-	void setCore(int core) override
-	{
-		core_ = core;
-	}
-
 private:
-	int core_;
-	std::string name_;
-
-	std::string to_print_;
-
-	std::string var_name_;
-	SymbolTable* table_ = nullptr;
-
-	std::vector<std::string>* log_list_ = nullptr;
-	bool dynamic_ = false;
+	Message message_;
+	std::string_view text_;
 
-	std::string getCurrentTimestamp()
+	std::string getCurrentTimestamp() const
 	{
 		auto now = std::chrono::system_clock::now();
 		std::time_t time_now = std::chrono::system_clock::to_time_t(now);
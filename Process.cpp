@@ -1,36 +1,97 @@
 #include "Process.hpp"
-#include "DeclareCommand.hpp"
 #include "AddCommand.hpp"
 #include "SubtractCommand.hpp"
-#include "SleepCommand.hpp"
-#include "ForCommand.hpp"
+#include "FusedArithmeticCommand.hpp"
+#include "EndForCommand.hpp"
 #include "SymbolTable.hpp"
+#include <cmath>
+#include <iostream>
 #include <random>
 #include <string>
 
-Process::Process(int pid, const std::string& name, const std::string& time, std::chrono::time_point<std::chrono::system_clock> creation_time, int core, int min_ins, int max_ins, size_t mem_per_proc, size_t mem_per_frame)
+Process::Process(int pid, const std::string& name, const std::string& time, std::chrono::time_point<std::chrono::system_clock> creation_time, int core, size_t mem_per_proc, size_t mem_per_frame)
     : pid_(pid),
     name_(name),
     time_(time),
 	creation_time_(creation_time),
     cpu_core_id_(core),
     process_state_(READY),
-    gen_(std::random_device{}()), 
+    seed_(std::random_device{}()),
     mem_per_proc_(mem_per_proc),
     mem_per_frame_(mem_per_frame),
     memory_(nullptr)
 {
     calculateFrame();
+    context_.pid = pid;
+    context_.name = name_;
+    context_.symbol_table = &symbol_table_;
+    context_.log_list = &log_list_;
 }
 
 
 void Process::executeCurrentCommand()
 {   
-    if (command_counter_ < command_list_.size())
+    const ICommand* command = fetchCommand();
+    if (command != nullptr)
     {
-        command_list_[command_counter_]->setCore(cpu_core_id_);
-        command_list_[command_counter_]->execute();
+        context_.core = cpu_core_id_;
+        command->execute(context_);
+        if (context_.sleep_ticks > 0)
+        {
+            setSleepTicks(context_.sleep_ticks);
+            process_state_ = WAITING;
+            context_.sleep_ticks = 0;
+        }
+        retire(command);
+    }
+}
+
+const ICommand* Process::fetchCommand()
+{
+    // Loops never span chunks, so pc_ only leaves a chunk forwards
+    if (chunk_ == nullptr || pc_ - chunk_->base >= static_cast<int>(chunk_->commands.size()))
+    {
+        if (!program_)
+        {
+            program_ = std::make_shared<ProgramImage>(seed_, min_ins_, max_ins_, fuse_instructions_, false);
+        }
+        chunk_ = program_->getChunk(++chunk_index_);
+        if (chunk_ == nullptr)
+        {
+            return nullptr;
+        }
+        context_.loop_iterations.assign(chunk_->loop_count, 0);
+    }
+
+    int index = pc_ - chunk_->base;
+    if (index >= static_cast<int>(chunk_->commands.size()))
+    {
+        return nullptr;
+    }
+    return chunk_->commands[index];
+}
+
+void Process::retire(const ICommand* command)
+{
+    // command_counter_ counts instruction lines retired; pc_ is the slot in
+    // the flat program, which a taken back-edge moves backwards
+    switch (command->getCommandType())
+    {
+    case ICommand::FUSED:
+        command_counter_ += FusedArithmeticCommand::LINES;
+        pc_ += FusedArithmeticCommand::LINES;
+        break;
+    case ICommand::END_FOR:
+    {
+        const EndForCommand* back_edge = static_cast<const EndForCommand*>(command);
         command_counter_++;
+        pc_ += context_.branch_taken ? back_edge->getJumpOffset() : 1;
+        break;
+    }
+    default:
+        command_counter_++;
+        pc_++;
+        break;
     }
 }
 
@@ -56,7 +117,7 @@ void* Process::getMemory() const
 
 int Process::getLinesOfCode() const
 {
-    return static_cast<int>(command_list_.size());
+    return lines_of_code_;
 }
 
 size_t Process::getMemoryRequired() const
@@ -105,193 +166,139 @@ std::chrono::time_point<std::chrono::system_clock> Process::getCreationTime() co
 	return creation_time_;
 }
 
-void Process::generateCommands(int min_ins, int max_ins)
-{ 
-    std::uniform_int_distribution<> distrib(min_ins, max_ins);
-    std::uniform_int_distribution<uint16_t> value_uint16(0, 65535);
-    std::uniform_int_distribution<int> value_uint8(0, 255); // Use int here
-
-
-    uint16_t int16 = 0;
-    uint8_t X = 0;
-    std::string varName = "";
-    std::string varName2 = "";
-    std::string varName3 = "";
-	std::string msg = "";
-
-    int num_commands = distrib(gen_);
-
-    for (int i = 1; i <= num_commands; ++i)
-    {
-        std::uniform_int_distribution<> cmd_type(0, 5);  // 6 possible commands: 0-5
-        int choice = cmd_type(gen_);
-
-        std::shared_ptr<ICommand> cmd;
-
-        switch (choice)
-        {
-        case 0:
-            msg = "Hello World From " + name_ + " started.";
-            cmd = std::make_shared<PrintCommand>(pid_, cpu_core_id_, msg, name_, &log_list_);
-        	break;
-
-        case 1:
-            varName = "var" + std::to_string(var_counter_++);
-            int16 = value_uint16(gen_);
-            cmd = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName, int16, &log_list_);
-            break;
+void Process::setArrivalTime(const std::string& time, std::chrono::time_point<std::chrono::system_clock> creation_time)
+{
+    time_ = time;
+    creation_time_ = creation_time;
+}
 
-        case 2:
-            varName = "var" + std::to_string(var_counter_++);
-            
-            int16 = value_uint16(gen_);
-            varName2 = "var" + std::to_string(var_counter_++);
-            cmd = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName2, int16, &log_list_);
-            command_list_.push_back(cmd);
+uint32_t Process::getSeed() const
+{
+    return seed_;
+}
 
-            int16 = value_uint16(gen_);
-            varName3 = "var" + std::to_string(var_counter_++);
+void Process::setSeed(uint32_t seed)
+{
+    seed_ = seed;
+}
 
-            cmd = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName3, int16, &log_list_);
-            command_list_.push_back(cmd);
+int Process::getPriorityLevel() const
+{
+    return priority_level_;
+}
 
-            cmd = std::make_shared<AddCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName, varName2, varName3, &log_list_);
-            break;
+int Process::getPriorityEpoch() const
+{
+    return priority_epoch_;
+}
 
-        case 3:
-            varName = "var" + std::to_string(var_counter_++);
+void Process::setPriorityLevel(int level, int epoch)
+{
+    priority_level_ = level;
+    priority_epoch_ = epoch;
+}
 
-            int16 = value_uint16(gen_);
-            varName2 = "var" + std::to_string(var_counter_++);
-            cmd = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName2, int16, &log_list_);
-            command_list_.push_back(cmd);
+int Process::getArrivalTick() const
+{
+    return arrival_tick_;
+}
 
-            int16 = value_uint16(gen_);
-            varName3 = "var" + std::to_string(var_counter_++);
+void Process::setArrivalTick(int tick)
+{
+    arrival_tick_ = tick;
+}
 
-            cmd = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName3, int16, &log_list_);
-            command_list_.push_back(cmd);
+long long Process::getArrivalNs() const
+{
+    return arrival_ns_;
+}
 
-            cmd = std::make_shared<SubtractCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName, varName2, varName3, &log_list_);
-            break;
+void Process::setArrivalNs(long long ns)
+{
+    arrival_ns_ = ns;
+}
 
-        case 4:
-            X = static_cast<uint8_t>(value_uint8(gen_));
-            cmd = std::make_shared<SleepCommand>(pid_, cpu_core_id_, X, &log_list_);
-            break;
+int Process::getReadyTick() const
+{
+    return ready_tick_;
+}
 
-        case 5:
-            int repeat_count = value_uint8(gen_) % 5 + 1;
-            int inner_cmd_count = value_uint8(gen_) % 3 + 1;
-            auto loop_cmds = generateRandomCommands(inner_cmd_count, 1);
-            cmd = std::make_shared<ForCommand>(pid_, cpu_core_id_, name_, loop_cmds, repeat_count, &log_list_);
-            break;
-        }
-        command_list_.push_back(cmd);
-        
-    } 
-    /* FOR NUMBER 4
-    std::uniform_int_distribution<> distrib(min_ins, max_ins);
-    std::uniform_int_distribution<uint16_t> value_uint10(1, 10);
+long long Process::getReadyNs() const
+{
+    return ready_ns_;
+}
 
-    int num_commands = distrib(gen_);
-    if (num_commands % 2 != 0) num_commands--;  // ensure even count for ADD + PRINT pairing
+void Process::setReadyTime(int tick, long long ns)
+{
+    ready_tick_ = tick;
+    ready_ns_ = ns;
+}
 
-    // Declare x = 0
-    symbol_table_.insert("x", ST(ST::DataType::UINT16, "0"));
+void Process::setDeadlineOffset(int ticks)
+{
+    deadline_offset_ = ticks;
+}
 
-    for (int i = 0; i < num_commands; i += 2)
-    {
-        std::shared_ptr<ICommand> cmd;
+bool Process::hasDeadline() const
+{
+    return deadline_offset_ >= 0;
+}
 
-        // Step 1: Update c with a new random value
-        uint16_t new_c_val = value_uint10(gen_);
-        symbol_table_.insert("c", ST(ST::DataType::UINT16, std::to_string(new_c_val)));
+int Process::getDeadlineTick() const
+{
+    return arrival_tick_ + deadline_offset_;
+}
 
-        // Step 2: Add x = x + c
-        cmd = std::make_shared<AddCommand>(
-            pid_, cpu_core_id_, name_, symbol_table_,
-            "x", "x", "c", &log_list_
-        );
-        command_list_.push_back(cmd);
+int Process::getFirstDispatchTick() const
+{
+    return first_dispatch_tick_;
+}
 
+void Process::setFirstDispatchTick(int tick)
+{
+    first_dispatch_tick_ = tick;
+}
 
-        cmd = std::make_shared<PrintCommand>(pid_, cpu_core_id_, "x", name_, symbol_table_, &log_list_);
-        command_list_.push_back(cmd);
-    }
-    */
+int Process::getMigrationCount() const
+{
+    return migration_count_;
 }
 
-std::vector<std::shared_ptr<ICommand>> Process::generateRandomCommands(int count, int depth)
+void Process::incrementMigrationCount()
 {
-    std::vector<std::shared_ptr<ICommand>> commands;
-    std::uniform_int_distribution<> cmd_type(0, 5); // same 6 types
-    std::uniform_int_distribution<uint16_t> value_uint16(0, 65535);
-    std::uniform_int_distribution<int> value_uint8(0, 255);
+    migration_count_++;
+}
 
-    for (int i = 0; i < count; ++i)
-    {
-        std::shared_ptr<ICommand> cmd;
-        int choice = cmd_type(gen_);
+void Process::generateCommands(int min_ins, int max_ins)
+{
+    // A private image: fetchCommand builds it on first dispatch, it generates
+    // instructions in chunks as this process reaches them, and each chunk is
+    // dropped once it has been run
+    min_ins_ = min_ins;
+    max_ins_ = max_ins;
+    program_.reset();
+    lines_of_code_ = ProgramImage::programLength(seed_, min_ins, max_ins);
+    resetProgramState();
+}
 
-        switch (choice)
-        {
-        case 0:
-        {
-            std::string msg = "Hello World From " + name_ + " started.";
-            cmd = std::make_shared<PrintCommand>(pid_, cpu_core_id_, msg, name_, &log_list_);
-            break;
-        }
-        case 1:
-        {
-            std::string varName = "var" + std::to_string(var_counter_++);
-            uint16_t value = value_uint16(gen_);
-            cmd = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName, value, &log_list_);
-            break;
-        }
-        case 2:
-        case 3:
-        {
-            std::string varName = "var" + std::to_string(var_counter_++);
-            std::string var2Name = "var" + std::to_string(var_counter_++);
-            std::string var3Name = "var" + std::to_string(var_counter_++);
-
-            auto d1 = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, var2Name, value_uint16(gen_), &log_list_);
-            auto d2 = std::make_shared<DeclareCommand>(pid_, cpu_core_id_, name_, symbol_table_, var3Name, value_uint16(gen_), &log_list_);
-            commands.push_back(d1);
-            commands.push_back(d2);
-
-            if (choice == 2)
-                cmd = std::make_shared<AddCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName, var2Name, var3Name, &log_list_);
-            else
-                cmd = std::make_shared<SubtractCommand>(pid_, cpu_core_id_, name_, symbol_table_, varName, var2Name, var3Name, &log_list_);
-            break;
-        }
-        case 4:
-        {
-            uint8_t ticks = static_cast<uint8_t>(value_uint8(gen_));
-            cmd = std::make_shared<SleepCommand>(pid_, cpu_core_id_, ticks, &log_list_);
-            break;
-        }
-        case 5:
-        {
-            if (depth < 3) 
-            {
-                int repeats = value_uint8(gen_) % 5 + 1;
-                int nested_count = value_uint8(gen_) % 3 + 1;
-                auto nested_cmds = generateRandomCommands(nested_count, depth + 1);
-                cmd = std::make_shared<ForCommand>(pid_, cpu_core_id_, name_, nested_cmds, repeats, &log_list_);
-                break;
-            }
-            continue;
-        }
-        }
+void Process::setProgram(std::shared_ptr<ProgramImage> program)
+{
+    program_ = std::move(program);
+    seed_ = program_->getSeed();
+    lines_of_code_ = program_->getLinesOfCode();
+    resetProgramState();
+}
 
-        if (cmd)
-            commands.push_back(cmd);
-    }
+void Process::resetProgramState()
+{
+    chunk_ = nullptr;
+    chunk_index_ = -1;
+    pc_ = 0;
+}
 
-    return commands;
+void Process::setFuseInstructions(bool enabled)
+{
+    fuse_instructions_ = enabled;
 }
 
 void Process::setAllocTime()
@@ -327,6 +334,91 @@ bool Process::isSleeping()
     return sleep_ticks_remaining_ > 0;
 }
 
+uint8_t Process::getSleepTicks() const
+{
+    return sleep_ticks_remaining_;
+}
+
+ProcessTask& Process::getTask()
+{
+    if (!task_.valid())
+    {
+        task_ = run();
+    }
+    return task_;
+}
+
+void Process::setBatchedArithmetic(bool enabled)
+{
+    batched_arithmetic_ = enabled;
+}
+
+bool Process::stageArithmetic()
+{
+    const ICommand* command = fetchCommand();
+    if (command == nullptr)
+    {
+        return false;
+    }
+
+    if (command->getCommandType() == ICommand::ADD)
+    {
+        static_cast<const AddCommand*>(command)->gather(context_, staged_lhs_, staged_rhs_);
+        staged_operation_ = ArithmeticBatch::ADD;
+    }
+    else if (command->getCommandType() == ICommand::SUBTRACT)
+    {
+        static_cast<const SubtractCommand*>(command)->gather(context_, staged_lhs_, staged_rhs_);
+        staged_operation_ = ArithmeticBatch::SUBTRACT;
+    }
+    else
+    {
+        return false;
+    }
+    staged_command_ = command;
+    return true;
+}
+
+size_t Process::stageInto(ArithmeticBatch& batch) const
+{
+    return batch.stage(staged_operation_, staged_lhs_, staged_rhs_);
+}
+
+void Process::commitArithmetic(uint16_t result)
+{
+    context_.core = cpu_core_id_;
+    if (staged_operation_ == ArithmeticBatch::ADD)
+    {
+        static_cast<const AddCommand*>(staged_command_)->commit(context_, result);
+    }
+    else
+    {
+        static_cast<const SubtractCommand*>(staged_command_)->commit(context_, result);
+    }
+    retire(staged_command_);
+    staged_command_ = nullptr;
+}
+
+ProcessTask Process::run()
+{
+    while (command_counter_ < lines_of_code_)
+    {
+        if (batched_arithmetic_ && stageArithmetic())
+        {
+            // The caller commits the result, which retires the instruction
+            co_yield ProcessTask::ALU;
+            continue;
+        }
+
+        executeCurrentCommand();
+        if (command_counter_ >= lines_of_code_)
+        {
+            break;
+        }
+        co_yield isSleeping() ? ProcessTask::SLEEP : ProcessTask::TICK;
+    }
+}
+
 void Process::pushToLog(const std::string& message)
 {
 	log_list_.push_back(message);
@@ -345,3 +437,24 @@ size_t Process::getLogCount() const
 	return log_list_.size();
 }
 
+
+
+std::string Process::getLogPath() const
+{
+    return name_ + ".txt";
+}
+
+ProcessRecord Process::createRecord() const
+{
+    ProcessRecord record;
+    record.name = name_;
+    record.time = time_;
+    record.log_path = getLogPath();
+    record.creation_time = creation_time_;
+    record.finish_time = std::chrono::system_clock::now();
+    record.pid = pid_;
+    record.command_counter = command_counter_;
+    record.lines_of_code = getLinesOfCode();
+    record.final_core = cpu_core_id_;
+    return record;
+}
\ No newline at end of file
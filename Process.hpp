@@ -7,6 +7,11 @@
 #include "ICommand.hpp"
 #include "AddCommand.hpp"
 #include "SymbolTable.hpp"
+#include "ProcessRecord.hpp"
+#include "ProcessTask.hpp"
+#include "ArithmeticBatch.hpp"
+#include "ProgramImage.hpp"
+#include "ExecutionContext.hpp"
 
 #include <memory>
 #include <string>
@@ -35,7 +40,7 @@ public:
         FINISHED
     };
 
-    Process(int pid, const std::string& name, const std::string& time, std::chrono::time_point<std::chrono::system_clock> creation_time, int core, int min_ins, int max_ins, size_t mem_per_proc, size_t mem_per_frame);
+    Process(int pid, const std::string& name, const std::string& time, std::chrono::time_point<std::chrono::system_clock> creation_time, int core, size_t mem_per_proc, size_t mem_per_frame);
     void executeCurrentCommand();
     int getCommandCounter() const;
     int getLinesOfCode() const;
@@ -48,6 +53,7 @@ public:
     std::string getName() const;
     std::string getTime() const;
     std::chrono::time_point<std::chrono::system_clock> getCreationTime() const;
+    void setArrivalTime(const std::string& time, std::chrono::time_point<std::chrono::system_clock> creation_time);
     void setMemory(void* memory);
     void* getMemory() const;
     void setAllocTime();
@@ -55,35 +61,99 @@ public:
     size_t getNumPages() const;
     void calculateFrame();
     void generateCommands(int min_ins, int max_ins);
-    std::vector<std::shared_ptr<ICommand>> generateRandomCommands(int count, int depth);
+    void setProgram(std::shared_ptr<ProgramImage> program);
+    uint32_t getSeed() const;
+    void setSeed(uint32_t seed);
+    int getPriorityLevel() const;
+    int getPriorityEpoch() const;
+    void setPriorityLevel(int level, int epoch);
+    int getArrivalTick() const;
+    void setArrivalTick(int tick);
+    long long getArrivalNs() const;
+    void setArrivalNs(long long ns);
+    int getReadyTick() const;
+    long long getReadyNs() const;
+    void setReadyTime(int tick, long long ns);
+    void setDeadlineOffset(int ticks);
+    bool hasDeadline() const;
+    int getDeadlineTick() const;
+    int getFirstDispatchTick() const;
+    int getMigrationCount() const;
+    void incrementMigrationCount();
+    void setFirstDispatchTick(int tick);
     void setSleepTicks(uint8_t ticks);
     void decrementSleepTick();
     bool isSleeping();
+    uint8_t getSleepTicks() const;
+    ProcessTask& getTask();
+    void setBatchedArithmetic(bool enabled);
+    void setFuseInstructions(bool enabled);
+    size_t stageInto(ArithmeticBatch& batch) const;
+    void commitArithmetic(uint16_t result);
 	void pushToLog(const std::string& message);
     void displayLogs() const;
     size_t getLogCount() const;
+    std::string getLogPath() const;
+    ProcessRecord createRecord() const;
 
 
 private:
     size_t pid_;
     std::string name_;
     std::string time_;
-    std::vector<std::shared_ptr<ICommand>> command_list_;
+    std::chrono::time_point<std::chrono::system_clock> creation_time_;
+    int cpu_core_id_;
+    ProcessState process_state_ = ProcessState::READY;
+    // Instructions come from an immutable image, either private to this
+    // process or shared through ProgramCache; the process keeps only its
+    // position in it and the state in context_. A private image is built on
+    // first dispatch, so until then a waiting process holds only the seed,
+    // the instruction range and lines_of_code_.
+    std::shared_ptr<ProgramImage> program_;
+    const ProgramImage::Chunk* chunk_ = nullptr;
+    int chunk_index_ = -1;
+    // Slot of the next command in the flat program; differs from
+    // command_counter_ once a loop has jumped back or a fused command ran
+    int pc_ = 0;
+    int lines_of_code_ = 0;
+    int min_ins_ = 0;
+    int max_ins_ = 0;
+    ExecutionContext context_;
+    uint32_t seed_;
     std::vector<std::string> log_list_;
     std::chrono::time_point<std::chrono::system_clock> allocation_time_;
     size_t mem_per_proc_;
     size_t mem_per_frame_;
     size_t num_pages_;
     int command_counter_ = 0;
-    int cpu_core_id_;
     RequirementFlags requirement_flags_;
     void* memory_;
     SymbolTable symbol_table_;
-    std::mt19937 gen_;
     uint8_t sleep_ticks_remaining_ = 0;
-    ProcessState process_state_ = ProcessState::READY;
-    int var_counter_ = 0;
-    std::chrono::time_point<std::chrono::system_clock> creation_time_;
+    int priority_level_ = 0;
+    int priority_epoch_ = 0;
+    int arrival_tick_ = 0;
+    int first_dispatch_tick_ = -1;
+    long long arrival_ns_ = 0;
+    int ready_tick_ = 0;
+    long long ready_ns_ = 0;
+    int deadline_offset_ = -1;
+    int migration_count_ = 0;
+    // Created on first use by the coroutine executor
+    ProcessTask task_;
+    bool fuse_instructions_ = false;
+    // ADD/SUBTRACT waiting for its ArithmeticBatch result
+    bool batched_arithmetic_ = false;
+    const ICommand* staged_command_ = nullptr;
+    ArithmeticBatch::Operation staged_operation_ = ArithmeticBatch::ADD;
+    uint16_t staged_lhs_ = 0;
+    uint16_t staged_rhs_ = 0;
+
+    ProcessTask run();
+    bool stageArithmetic();
+    const ICommand* fetchCommand();
+    void resetProgramState();
+    void retire(const ICommand* command);
 
 };
 
@@ -0,0 +1,163 @@
+#include "ProcessCreationPipeline.hpp"
+#include "ProcessManager.hpp"
+#include "Process.hpp"
+
+#include <algorithm>
+
+ProcessCreationPipeline::ProcessCreationPipeline(ProcessManager* process_manager, int num_builders, size_t lookahead)
+    : process_manager_(process_manager), num_builders_(num_builders < 1 ? 1 : num_builders),
+    lookahead_(lookahead < 1 ? 1 : lookahead)
+{
+}
+
+ProcessCreationPipeline::~ProcessCreationPipeline()
+{
+    stop();
+}
+
+void ProcessCreationPipeline::start(int first_index)
+{
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    if (is_running_)
+    {
+        return;
+    }
+
+    is_running_ = true;
+    // Names never go backwards: processes left over from the last run
+    // already hold the ones below next_name_index_
+    next_name_index_ = std::max(next_name_index_, first_index);
+
+    for (int i = 0; i < num_builders_; ++i)
+    {
+        builder_threads_.emplace_back(&ProcessCreationPipeline::build, this);
+    }
+}
+
+void ProcessCreationPipeline::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(pipeline_mutex_);
+        is_running_ = false;
+    }
+    pipeline_condition_.notify_all();
+
+    for (auto& thread : builder_threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+    builder_threads_.clear();
+}
+
+bool ProcessCreationPipeline::isRunning() const
+{
+    return is_running_;
+}
+
+std::shared_ptr<Process> ProcessCreationPipeline::take()
+{
+    std::shared_ptr<Process> process;
+    {
+        std::lock_guard<std::mutex> lock(pipeline_mutex_);
+        auto it = built_.find(next_take_index_);
+        if (it == built_.end())
+        {
+            return nullptr;
+        }
+
+        process = it->second;
+        built_.erase(it);
+        next_take_index_++;
+    }
+
+    pipeline_condition_.notify_one();
+    return process;
+}
+
+std::shared_ptr<Process> ProcessCreationPipeline::rebuild(const std::shared_ptr<Process>& process)
+{
+    std::string name;
+    {
+        std::lock_guard<std::mutex> lock(pipeline_mutex_);
+        name = nextName();
+    }
+    return process_manager_->createProcess(name, static_cast<int>(process->getPID()));
+}
+
+void ProcessCreationPipeline::recordArrival(int due_tick, int publish_tick)
+{
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    int lag = publish_tick - due_tick;
+    if (lag < 0)
+    {
+        lag = 0;
+    }
+
+    metrics_.arrivals++;
+    metrics_.total_lag_ticks += lag;
+    if (lag > 0)
+    {
+        metrics_.late_arrivals++;
+    }
+    if (lag > metrics_.max_lag_ticks)
+    {
+        metrics_.max_lag_ticks = lag;
+    }
+}
+
+ProcessCreationPipeline::Metrics ProcessCreationPipeline::getMetrics()
+{
+    std::lock_guard<std::mutex> lock(pipeline_mutex_);
+    return metrics_;
+}
+
+std::string ProcessCreationPipeline::nextName()
+{
+    // Skips names a user took with screen -s; called with pipeline_mutex_ held
+    std::string name = "process" + std::to_string(next_name_index_++);
+    while (process_manager_->hasProcess(name))
+    {
+        name = "process" + std::to_string(next_name_index_++);
+    }
+    return name;
+}
+
+void ProcessCreationPipeline::build()
+{
+    while (true)
+    {
+        int index;
+        int pid;
+        std::string name;
+        {
+            std::unique_lock<std::mutex> lock(pipeline_mutex_);
+            pipeline_condition_.wait(lock, [this]
+                {
+                    return !is_running_ || built_.size() + in_flight_ < lookahead_;
+                });
+
+            if (!is_running_)
+            {
+                break;
+            }
+
+            // Reserving the pid with the index keeps pids in arrival order.
+            index = next_build_index_++;
+            name = nextName();
+            pid = process_manager_->reservePid();
+            in_flight_++;
+        }
+
+        std::shared_ptr<Process> process = process_manager_->createProcess(name, pid);
+
+        {
+            std::lock_guard<std::mutex> lock(pipeline_mutex_);
+            in_flight_--;
+            built_[index] = process;
+            metrics_.built++;
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef PROCESS_CREATION_PIPELINE_H
+#define PROCESS_CREATION_PIPELINE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Process;
+class ProcessManager;
+
+// Pre-builds batch processes on a pool of builder threads so the scheduler-start
+// tick thread only has to publish them when their arrival tick comes due.
+// Built processes outlive scheduler-stop and are published first on the next
+// start, so every reserved pid ends up on a published process.
+class ProcessCreationPipeline
+{
+public:
+    struct Metrics
+    {
+        long long arrivals = 0;
+        long long late_arrivals = 0;
+        long long total_lag_ticks = 0;
+        int max_lag_ticks = 0;
+        long long built = 0;
+    };
+
+    ProcessCreationPipeline(ProcessManager* process_manager, int num_builders, size_t lookahead);
+    ~ProcessCreationPipeline();
+
+    void start(int first_index);
+    void stop();
+    bool isRunning() const;
+    std::shared_ptr<Process> take();
+    // Builds a replacement under the next free name, keeping the pid, for a
+    // process whose name was taken after it was built
+    std::shared_ptr<Process> rebuild(const std::shared_ptr<Process>& process);
+    void recordArrival(int due_tick, int publish_tick);
+    Metrics getMetrics();
+
+private:
+    void build();
+    std::string nextName();
+
+    ProcessManager* process_manager_;
+    int num_builders_;
+    size_t lookahead_;
+    bool is_running_ = false;
+    int next_build_index_ = 0;
+    int next_take_index_ = 0;
+    int next_name_index_ = 0;
+    size_t in_flight_ = 0;
+    std::map<int, std::shared_ptr<Process>> built_;
+    std::vector<std::thread> builder_threads_;
+    std::mutex pipeline_mutex_;
+    std::condition_variable pipeline_condition_;
+    Metrics metrics_;
+};
+
+#endif
@@ -7,7 +7,7 @@
 #include <cmath>
 
 ProcessManager::ProcessManager(int min_ins, int max_ins, int n_cpu, std::string scheduler_algo, int delays_per_exec,
-    int quantum_cycle, Clock* cpu_clock, size_t max_overall_mem, size_t mem_per_frame, size_t mem_per_proc)
+    int quantum_cycle, Clock* cpu_clock, size_t max_overall_mem, size_t mem_per_frame, size_t mem_per_proc, int creation_threads)
     : min_ins_(min_ins), max_ins_(max_ins), cpu_clock(cpu_clock), num_cpu_(n_cpu), mem_per_proc(mem_per_proc),max_overall_mem(max_overall_mem), mem_per_frame(mem_per_frame)
 {
 
@@ -23,32 +23,183 @@ ProcessManager::ProcessManager(int min_ins, int max_ins, int n_cpu, std::string
     scheduler_ = new Scheduler(scheduler_algo, delays_per_exec, n_cpu, quantum_cycle, cpu_clock, memory_allocator_);
     scheduler_->setNumCPUs(n_cpu);
 
+    creation_pipeline_ = new ProcessCreationPipeline(this, creation_threads, static_cast<size_t>(creation_threads) * 4);
+}
+
+void ProcessManager::start()
+{
     scheduler_thread_ = std::thread(&Scheduler::start, scheduler_);
 }
 
-void ProcessManager::addProcess(std::string name, std::string time, std::chrono::time_point<std::chrono::system_clock> creation_time)
+void ProcessManager::addProcess(std::string name, std::string time, std::chrono::time_point<std::chrono::system_clock> creation_time, int deadline_offset)
 {
-    pid_counter_++;
-    auto process = std::make_shared<Process>(pid_counter_, name, time, creation_time, -1, min_ins_, max_ins_, mem_per_proc, mem_per_frame);
-    process_list_[name] = process;
+    std::shared_ptr<Process> process = createProcess(name, reservePid());
+    process->setDeadlineOffset(deadline_offset);
+    publishProcess(process, time, creation_time);
+}
+
+int ProcessManager::reservePid()
+{
+    return ++pid_counter_;
+}
+
+std::shared_ptr<Process> ProcessManager::createProcess(const std::string& name, int pid)
+{
+    auto process = std::make_shared<Process>(pid, name, "", std::chrono::system_clock::now(), -1, mem_per_proc, mem_per_frame);
+    if (program_templates_ > 0)
+    {
+        // Templates are picked by name so a seeded run is still independent
+        // of creation order
+        int index = static_cast<int>(deriveSeed(name) % static_cast<uint32_t>(program_templates_));
+        uint32_t seed = deriveSeed("template" + std::to_string(index)) ^ program_template_salt_;
+        process->setProgram(program_cache_.acquire(seed, min_ins_, max_ins_, fuse_instructions_));
+        return process;
+    }
+    if (use_global_seed_)
+    {
+        process->setSeed(deriveSeed(name));
+    }
+    process->setFuseInstructions(fuse_instructions_);
     process->generateCommands(min_ins_, max_ins_);
+    return process;
+}
+
+void ProcessManager::setFuseInstructions(bool enabled)
+{
+    fuse_instructions_ = enabled;
+}
+
+void ProcessManager::setProgramTemplates(int count)
+{
+    program_templates_ = count;
+    // Without a global seed the templates differ between runs, like the
+    // programs of untemplated processes do
+    program_template_salt_ = use_global_seed_ ? 0 : std::random_device{}();
+}
+
+void ProcessManager::setGlobalSeed(uint32_t seed)
+{
+    use_global_seed_ = true;
+    global_seed_ = seed;
+}
+
+uint32_t ProcessManager::deriveSeed(const std::string& name) const
+{
+    // FNV-1a over the process name, keyed by the global seed, so a process gets
+    // the same program in every run regardless of creation order.
+    uint64_t hash = 14695981039346656037ULL ^ global_seed_;
+    for (unsigned char c : name)
+    {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return static_cast<uint32_t>(hash ^ (hash >> 32));
+}
+
+Scheduler* ProcessManager::getScheduler()
+{
+    return scheduler_;
+}
+
+void ProcessManager::publishProcess(std::shared_ptr<Process> process, std::string time, std::chrono::time_point<std::chrono::system_clock> creation_time)
+{
+    process->setArrivalTime(time, creation_time);
+    {
+        std::lock_guard<std::mutex> lock(process_list_mutex_);
+        process_list_[process->getName()] = process;
+    }
     scheduler_->addProcess(process);
 }
 
+ProcessCreationPipeline& ProcessManager::getCreationPipeline()
+{
+    return *creation_pipeline_;
+}
+
 std::shared_ptr<Process> ProcessManager::getProcess(std::string name)
 {
-    if (process_list_.find(name) != process_list_.end())
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    auto it = process_list_.find(name);
+    if (it != process_list_.end())
     {
-        return process_list_[name];
+        return it->second;
     }
     return nullptr;
 }
 
+bool ProcessManager::hasProcess(const std::string& name)
+{
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    return process_list_.count(name) > 0 || finished_index_.count(name) > 0;
+}
+
 std::map<std::string, std::shared_ptr<Process>> ProcessManager::getAllProcess()
 {
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
     return process_list_;
 }
 
+void ProcessManager::archiveProcess(std::shared_ptr<Process> process)
+{
+    ProcessRecord record = process->createRecord();
+
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    auto it = process_list_.find(record.name);
+    if (it == process_list_.end() || it->second != process)
+    {
+        return;
+    }
+
+    // Dropping the map entry releases the instruction list, symbol table and
+    // in-memory logs once the last scheduler reference goes away.
+    process_list_.erase(it);
+    finished_index_[record.name] = finished_list_.size();
+    finished_list_.push_back(std::move(record));
+}
+
+bool ProcessManager::getFinishedProcess(const std::string& name, ProcessRecord& record)
+{
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    auto it = finished_index_.find(name);
+    if (it == finished_index_.end())
+    {
+        return false;
+    }
+    record = finished_list_[it->second];
+    return true;
+}
+
+void ProcessManager::forEachFinishedProcess(const std::function<void(const ProcessRecord&)>& visitor)
+{
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    for (const ProcessRecord& record : finished_list_)
+    {
+        visitor(record);
+    }
+}
+
+size_t ProcessManager::getFinishedCount()
+{
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    return finished_list_.size();
+}
+
+size_t ProcessManager::getArchiveBytes()
+{
+    std::lock_guard<std::mutex> lock(process_list_mutex_);
+    // Records plus the heap behind their strings; short names fit in the
+    // string object itself
+    size_t archive_bytes = finished_list_.capacity() * sizeof(ProcessRecord);
+    const size_t inline_capacity = std::string().capacity();
+    for (const ProcessRecord& record : finished_list_)
+    {
+        archive_bytes += record.name.capacity() > inline_capacity ? record.name.capacity() + 1 : 0;
+        archive_bytes += record.time.capacity() > inline_capacity ? record.time.capacity() + 1 : 0;
+        archive_bytes += record.log_path.capacity() > inline_capacity ? record.log_path.capacity() + 1 : 0;
+    }
+    return archive_bytes;
+}
+
 void ProcessManager::processSmi()
 {
     static std::mutex process_list_mutex;
@@ -56,8 +207,8 @@ void ProcessManager::processSmi()
     size_t memory_usage = 0;
     int core_usage = 0;
 
-    const std::vector<std::string>& run = CoreStateManager::getInstance().getProcess();
-    const std::vector<int>& core_states = CoreStateManager::getInstance().getCoreStates();
+    std::vector<std::string> run = CoreStateManager::getInstance().getProcess();
+    std::vector<int> core_states = CoreStateManager::getInstance().getCoreStates();
 
     for (bool core_state : core_states)
     {
@@ -88,7 +239,7 @@ void ProcessManager::processSmi()
     std::cout << "| PROCESS-SMI V01.00 Driver Version: 01.00 |\n";
     std::cout << "--------------------------------------------\n";
 
-    std::cout << "CPU-Util: " << (static_cast<double>(core_usage) / num_cpu_) * 100 << "%" << std::endl;
+    std::cout << "CPU-Util: " << (static_cast<double>(core_usage) / scheduler_->getNumCPUs()) * 100 << "%" << std::endl;
     std::cout << "Memory Usage: " << memory_usage << "KB" << " / " << max_overall_mem << "KB" << std::endl;
     std::cout << "Memory Util: " << (static_cast<double>(memory_usage) / max_overall_mem) * 100 << "%" << std::endl;
 
@@ -104,6 +255,12 @@ ProcessManager::~ProcessManager()
 {
     std::cout << "[ProcessManager] Shutting down...\n";
 
+    if (creation_pipeline_) {
+        creation_pipeline_->stop();
+        delete creation_pipeline_;
+        creation_pipeline_ = nullptr;
+    }
+
     if (scheduler_) {
         std::cout << "[ProcessManager] Stopping scheduler...\n";
 
@@ -133,7 +290,147 @@ void ProcessManager::vmStat()
     std::cout << std::setw(12) << cpu_clock->getCpuClock() - cpu_clock->getActiveCpuNum() << " idle cpu ticks" << std::endl;
     std::cout << std::setw(12) << cpu_clock->getActiveCpuNum() << " active cpu ticks" << std::endl;
     std::cout << std::setw(12) << cpu_clock->getCpuClock() << " total cpu ticks" << std::endl;
+    std::cout << std::setw(12) << cpu_clock->getTickPeriod() << " us tick period" << std::endl;
+    std::cout << std::setw(12) << cpu_clock->getLateTicks() << " late ticks" << std::endl;
+    std::cout << std::setw(12) << cpu_clock->getMissedTicks() << " missed ticks" << std::endl;
+    std::cout << std::setw(12) << cpu_clock->getHeldNs() / 1000 << " us clock held by cores" << std::endl;
     std::cout << std::setw(12) << memory_allocator_->getPageIn() << " pages paged in" << std::endl;
     std::cout << std::setw(12) << memory_allocator_->getPageOut() << " pages paged out" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(process_list_mutex_);
+        std::cout << std::setw(12) << process_list_.size() << " live processes" << std::endl;
+        std::cout << std::setw(12) << finished_list_.size() << " finished processes archived" << std::endl;
+    }
+    std::cout << std::setw(12) << getArchiveBytes() / 1024 << " KB archive size" << std::endl;
+    if (program_templates_ > 0)
+    {
+        ProgramCache::Stats programs = program_cache_.getStats();
+        std::cout << std::setw(12) << programs.images << " shared program images" << std::endl;
+        std::cout << std::setw(12) << programs.hits << " program cache hits" << std::endl;
+        std::cout << std::setw(12) << programs.misses << " program cache misses" << std::endl;
+    }
+
+    ProcessCreationPipeline::Metrics arrivals = creation_pipeline_->getMetrics();
+    std::cout << std::setw(12) << arrivals.arrivals << " batch arrivals" << std::endl;
+    std::cout << std::setw(12) << arrivals.late_arrivals << " late batch arrivals" << std::endl;
+    std::cout << std::setw(12) << std::fixed << std::setprecision(2)
+        << (arrivals.arrivals > 0 ? static_cast<double>(arrivals.total_lag_ticks) / arrivals.arrivals : 0.0)
+        << " mean arrival lag ticks" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+    std::cout << std::setw(12) << arrivals.max_lag_ticks << " max arrival lag ticks" << std::endl;
+    std::vector<size_t> level_sizes = scheduler_->getQueueLevelSizes();
+    for (size_t i = 0; i < level_sizes.size(); ++i)
+    {
+        std::cout << std::setw(12) << level_sizes[i] << " ready in queue level " << i << std::endl;
+    }
+    std::cout << std::setw(12) << std::fixed << std::setprecision(2) << scheduler_->getMeanResponseTime()
+        << " mean response time ticks" << std::endl;
+
+    double turnaround_mean;
+    int turnaround_p50;
+    int turnaround_p99;
+    size_t turnaround_count;
+    scheduler_->getTurnaroundStats(turnaround_mean, turnaround_p50, turnaround_p99, turnaround_count);
+    std::cout << std::setw(12) << turnaround_mean << " mean turnaround ticks (" << scheduler_->getAlgorithm() << ", " << turnaround_count << " finished)" << std::endl;
+    std::cout << std::setw(12) << turnaround_p50 << " p50 turnaround ticks" << std::endl;
+    std::cout << std::setw(12) << turnaround_p99 << " p99 turnaround ticks" << std::endl;
+
+    long long deadlines_met;
+    long long deadlines_missed;
+    std::vector<long long> lateness_histogram;
+    scheduler_->getDeadlineStats(deadlines_met, deadlines_missed, lateness_histogram);
+    if (deadlines_met + deadlines_missed > 0)
+    {
+        std::cout << std::setw(12) << deadlines_met << " deadlines met" << std::endl;
+        std::cout << std::setw(12) << deadlines_missed << " deadlines missed" << std::endl;
+        for (size_t i = 1; i < lateness_histogram.size(); ++i)
+        {
+            if (lateness_histogram[i] > 0)
+            {
+                std::cout << std::setw(12) << lateness_histogram[i] << " late by ";
+                if (i + 1 == lateness_histogram.size())
+                {
+                    // Last bucket also holds everything past its range
+                    std::cout << ">= " << (1 << (i - 1));
+                }
+                else
+                {
+                    std::cout << (1 << (i - 1)) << "-" << (1 << i) - 1;
+                }
+                std::cout << " ticks" << std::endl;
+            }
+        }
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+
+    std::vector<long long> core_migrations = scheduler_->getCoreMigrations();
+    for (size_t i = 0; i < core_migrations.size(); ++i)
+    {
+        std::cout << std::setw(12) << core_migrations[i] << " migrations onto core " << i + 1 << std::endl;
+    }
+
+    std::vector<long long> switch_counts;
+    std::vector<long long> switch_ticks;
+    scheduler_->getSwitchStats(switch_counts, switch_ticks);
+    long long total_switch_ticks = 0;
+    for (size_t i = 0; i < switch_counts.size(); ++i)
+    {
+        Scheduler::SwitchKind kind = static_cast<Scheduler::SwitchKind>(i);
+        std::cout << std::setw(12) << switch_counts[i] << " " << Scheduler::switchKindName(kind) << " switches" << std::endl;
+        total_switch_ticks += switch_ticks[i];
+    }
+    std::cout << std::setw(12) << total_switch_ticks << " context switch ticks" << std::endl;
+    std::cout << std::setw(12) << scheduler_->getCurrentQuantum() << " current quantum cycles" << std::endl;
+    std::cout << std::setw(12) << scheduler_->getQuantumAdjustments() << " quantum adjustments" << std::endl;
+
+    std::vector<double> throughput = scheduler_->getCoreThroughput();
+    std::cout << std::fixed << std::setprecision(0);
+    for (size_t i = 0; i < throughput.size(); ++i)
+    {
+        std::cout << std::setw(12) << throughput[i] << " instructions/s on core " << i + 1 << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+
+    if (scheduler_->getTrace().isReplaying())
+    {
+        std::cout << std::setw(12) << scheduler_->getTrace().getDivergences() << " replay divergences" << std::endl;
+    }
     std::cout << "==========================================" << std::endl;
 }
+
+void ProcessManager::schedStats(std::ostream& out)
+{
+    out << "==========================================" << std::endl;
+    out << std::left << std::setw(22) << "Scheduler latency" << std::right
+        << std::setw(10) << "count" << std::setw(14) << "p50" << std::setw(14) << "p90"
+        << std::setw(14) << "p99" << std::setw(14) << "max" << std::endl;
+
+    const LatencyHistogram* clock_histograms[] = { &cpu_clock->getTickJitter(), &cpu_clock->getWakeupLatency() };
+    const char* clock_names[] = { "tick jitter (ns)", "tick wakeup (ns)" };
+    for (int i = 0; i < 2; ++i)
+    {
+        out << std::left << std::setw(22) << clock_names[i] << std::right
+            << std::setw(10) << clock_histograms[i]->getCount()
+            << std::setw(14) << clock_histograms[i]->getPercentile(50)
+            << std::setw(14) << clock_histograms[i]->getPercentile(90)
+            << std::setw(14) << clock_histograms[i]->getPercentile(99)
+            << std::setw(14) << clock_histograms[i]->getMax() << std::endl;
+    }
+
+    LatencyHistogram merged;
+    for (int i = 0; i < Scheduler::LATENCY_METRICS; ++i)
+    {
+        Scheduler::LatencyMetric metric = static_cast<Scheduler::LatencyMetric>(i);
+        scheduler_->mergeLatency(metric, merged);
+        out << std::left << std::setw(22) << Scheduler::latencyMetricName(metric) << std::right
+            << std::setw(10) << merged.getCount()
+            << std::setw(14) << merged.getPercentile(50)
+            << std::setw(14) << merged.getPercentile(90)
+            << std::setw(14) << merged.getPercentile(99)
+            << std::setw(14) << merged.getMax() << std::endl;
+    }
+    out << "==========================================" << std::endl;
+}
@@ -5,19 +5,27 @@
 #include "Scheduler.hpp"
 #include "Clock.hpp"
 #include "FlatMemoryAllocator.hpp"
+#include "ProcessRecord.hpp"
+#include "ProcessCreationPipeline.hpp"
+#include "ProgramCache.hpp"
 
 #include <map>
+#include <unordered_map>
 #include <memory>
 #include <vector>
 #include <iostream>
 #include <thread>
 #include <mutex>
+#include <atomic>
+#include <functional>
 
 class ProcessManager
 {
 private:
     std::map<std::string, std::shared_ptr<Process>> process_list_;
-    int pid_counter_ = 0;
+    std::vector<ProcessRecord> finished_list_;
+    std::unordered_map<std::string, size_t> finished_index_;
+    std::atomic<int> pid_counter_{ 0 };
     Scheduler* scheduler_;
     std::thread scheduler_thread_;
     int min_ins_;
@@ -30,19 +38,51 @@ private:
     int num_cpu_;
     std::mutex process_list_mutex_;
     std::mutex core_states_mutex_;
+    ProcessCreationPipeline* creation_pipeline_;
+    bool use_global_seed_ = false;
+    bool fuse_instructions_ = false;
+    uint32_t global_seed_ = 0;
+    // When set, each process runs one of this many template programs and
+    // processes on the same template share its image
+    int program_templates_ = 0;
+    uint32_t program_template_salt_ = 0;
+    ProgramCache program_cache_;
+
+    uint32_t deriveSeed(const std::string& name) const;
 
 public:
     ProcessManager(int min_ins, int max_ins, int n_cpu, std::string scheduler_algo, int delays_per_exec,
-        int quantum_cycle, Clock* cpu_clock, size_t max_overall_mem, size_t mem_per_frame, size_t mem_per_proc);
+        int quantum_cycle, Clock* cpu_clock, size_t max_overall_mem, size_t mem_per_frame, size_t mem_per_proc, int creation_threads);
 
-    void addProcess(std::string name, std::string time, std::chrono::time_point<std::chrono::system_clock> creation_time);
+    void addProcess(std::string name, std::string time, std::chrono::time_point<std::chrono::system_clock> creation_time, int deadline_offset = -1);
+    int reservePid();
+    std::shared_ptr<Process> createProcess(const std::string& name, int pid);
+    void setGlobalSeed(uint32_t seed);
+    void setFuseInstructions(bool enabled);
+    void setProgramTemplates(int count);
+    Scheduler* getScheduler();
+    void start();
+    void publishProcess(std::shared_ptr<Process> process, std::string time, std::chrono::time_point<std::chrono::system_clock> creation_time);
+    ProcessCreationPipeline& getCreationPipeline();
     std::shared_ptr<Process> getProcess(std::string name);
+    // True for live and archived processes alike
+    bool hasProcess(const std::string& name);
     std::map<std::string, std::shared_ptr<Process>> getAllProcess();
+    void archiveProcess(std::shared_ptr<Process> process);
+    bool getFinishedProcess(const std::string& name, ProcessRecord& record);
+    // Visits archived records under the process list lock, without copying
+    // the archive; the visitor must not call back into ProcessManager
+    void forEachFinishedProcess(const std::function<void(const ProcessRecord&)>& visitor);
+    size_t getFinishedCount();
+    // Bytes held by the archived records and their strings, not counting
+    // the name index
+    size_t getArchiveBytes();
 
     ~ProcessManager();
 
     void processSmi();
     void vmStat();
+    void schedStats(std::ostream& out);
 };
 
 #endif
\ No newline at end of file
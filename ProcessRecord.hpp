@@ -0,0 +1,23 @@
+#ifndef PROCESS_RECORD_H
+#define PROCESS_RECORD_H
+
+#include <string>
+#include <chrono>
+
+// Compact summary of a FINISHED process. Kept by ProcessManager in place of the
+// full Process once its instructions, symbol table and in-memory logs are no longer needed.
+struct ProcessRecord
+{
+    std::string name;
+    std::string time;
+    // Log file written while the process ran; screen -r reads it back from disk
+    std::string log_path;
+    std::chrono::time_point<std::chrono::system_clock> creation_time;
+    std::chrono::time_point<std::chrono::system_clock> finish_time;
+    size_t pid = 0;
+    int command_counter = 0;
+    int lines_of_code = 0;
+    int final_core = -1;
+};
+
+#endif
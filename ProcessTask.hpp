@@ -0,0 +1,96 @@
+#ifndef PROCESS_TASK_H
+#define PROCESS_TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+// Coroutine handle for a process running under the coroutine executor.
+// The body runs one instruction per resume and reports why it suspended:
+// TICK to continue on the next tick, SLEEP after a SLEEP instruction,
+// ALU with an ADD/SUBTRACT staged for the caller's ArithmeticBatch,
+// DONE once the program has finished.
+class ProcessTask
+{
+public:
+    enum Suspend
+    {
+        TICK,
+        SLEEP,
+        ALU,
+        DONE
+    };
+
+    struct promise_type
+    {
+        Suspend reason = TICK;
+
+        ProcessTask get_return_object()
+        {
+            return ProcessTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(Suspend suspend_reason)
+        {
+            reason = suspend_reason;
+            return {};
+        }
+        void return_void() { reason = DONE; }
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    ProcessTask() = default;
+
+    explicit ProcessTask(std::coroutine_handle<promise_type> handle) : handle_(handle)
+    {
+    }
+
+    ProcessTask(ProcessTask&& other) noexcept : handle_(std::exchange(other.handle_, {}))
+    {
+    }
+
+    ProcessTask& operator=(ProcessTask&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle_)
+            {
+                handle_.destroy();
+            }
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ProcessTask(const ProcessTask&) = delete;
+    ProcessTask& operator=(const ProcessTask&) = delete;
+
+    ~ProcessTask()
+    {
+        if (handle_)
+        {
+            handle_.destroy();
+        }
+    }
+
+    bool valid() const
+    {
+        return static_cast<bool>(handle_);
+    }
+
+    Suspend resume()
+    {
+        if (!handle_ || handle_.done())
+        {
+            return DONE;
+        }
+        handle_.resume();
+        return handle_.promise().reason;
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+#endif
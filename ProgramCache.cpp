@@ -0,0 +1,39 @@
+#include "ProgramCache.hpp"
+
+#include <algorithm>
+
+std::shared_ptr<ProgramImage> ProgramCache::acquire(uint32_t seed, int min_ins, int max_ins, bool fuse_instructions)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Key key(seed, min_ins, max_ins, fuse_instructions);
+    auto it = images_.find(key);
+    if (it != images_.end())
+    {
+        if (std::shared_ptr<ProgramImage> image = it->second.lock())
+        {
+            stats_.hits++;
+            return image;
+        }
+    }
+
+    stats_.misses++;
+    // Drop entries whose images died with their last process
+    std::erase_if(images_, [](const auto& entry)
+        {
+            return entry.second.expired();
+        });
+    auto image = std::make_shared<ProgramImage>(seed, min_ins, max_ins, fuse_instructions, true);
+    images_[key] = image;
+    return image;
+}
+
+ProgramCache::Stats ProgramCache::getStats()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.images = std::count_if(images_.begin(), images_.end(), [](const auto& entry)
+        {
+            return !entry.second.expired();
+        });
+    return stats;
+}
@@ -0,0 +1,39 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+#include "ProgramImage.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+// Hands out shared ProgramImages keyed by everything that determines the
+// generated program, so processes built from the same template run one
+// copy of the instructions. The cache only holds weak references, so an
+// image is freed with the last process running it and regenerated from its
+// seed if the template comes up again.
+class ProgramCache
+{
+public:
+    struct Stats
+    {
+        // Images still held by at least one process
+        size_t images = 0;
+        long long hits = 0;
+        long long misses = 0;
+    };
+
+    std::shared_ptr<ProgramImage> acquire(uint32_t seed, int min_ins, int max_ins, bool fuse_instructions);
+    Stats getStats();
+
+private:
+    using Key = std::tuple<uint32_t, int, int, bool>;
+
+    std::mutex mutex_;
+    std::map<Key, std::weak_ptr<ProgramImage>> images_;
+    Stats stats_;
+};
+
+#endif
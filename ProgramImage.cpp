@@ -0,0 +1,297 @@
+#include "ProgramImage.hpp"
+#include "PrintCommand.hpp"
+#include "DeclareCommand.hpp"
+#include "AddCommand.hpp"
+#include "SubtractCommand.hpp"
+#include "SleepCommand.hpp"
+#include "ForCommand.hpp"
+#include "EndForCommand.hpp"
+#include "FusedArithmeticCommand.hpp"
+
+#include <string>
+
+ProgramImage::ProgramImage(uint32_t seed, int min_ins, int max_ins, bool fuse_instructions, bool shared)
+    : seed_(seed),
+    fuse_instructions_(fuse_instructions),
+    shared_(shared)
+{
+    // Only the program length is fixed here; instructions are generated in
+    // chunks by generateNextChunk() as processes reach them.
+    gen_.seed(seed_);
+    lines_of_code_ = drawLength(gen_, min_ins, max_ins);
+}
+
+int ProgramImage::drawLength(std::minstd_rand& gen, int min_ins, int max_ins)
+{
+    std::uniform_int_distribution<> distrib(min_ins, max_ins);
+    return distrib(gen);
+}
+
+int ProgramImage::programLength(uint32_t seed, int min_ins, int max_ins)
+{
+    std::minstd_rand gen(seed);
+    return drawLength(gen, min_ins, max_ins);
+}
+
+const ProgramImage::Chunk* ProgramImage::getChunk(int index)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (index >= first_chunk_ + static_cast<int>(chunks_.size()) && lines_generated_ < lines_of_code_)
+    {
+        generateNextChunk();
+    }
+
+    int offset = index - first_chunk_;
+    if (offset < 0 || offset >= static_cast<int>(chunks_.size()))
+    {
+        return nullptr;
+    }
+    // deque::push_back keeps references valid, so the chunk can be read
+    // without the lock while later chunks are generated
+    return &chunks_[offset];
+}
+
+int ProgramImage::getLinesOfCode() const
+{
+    return lines_of_code_;
+}
+
+uint32_t ProgramImage::getSeed() const
+{
+    return seed_;
+}
+
+bool ProgramImage::isShared() const
+{
+    return shared_;
+}
+
+std::string_view ProgramImage::nextVarName()
+{
+    return arena_.intern("var" + std::to_string(var_counter_++));
+}
+
+void ProgramImage::generateNextChunk()
+{
+    std::uniform_int_distribution<uint16_t> value_uint16(0, 65535);
+    std::uniform_int_distribution<int> value_uint8(0, 255); // Use int here
+
+    if (!shared_ && !chunks_.empty())
+    {
+        // The only reader has moved past the previous chunk; drop it and
+        // its commands in one step
+        first_chunk_ += static_cast<int>(chunks_.size());
+        chunks_.clear();
+        arena_.reset();
+    }
+
+    chunks_.push_back(Chunk{ next_base_, {}, 0 });
+    Chunk& chunk = chunks_.back();
+    std::vector<const ICommand*>& commands = chunk.commands;
+
+    uint16_t int16 = 0;
+    uint8_t X = 0;
+    std::string_view varName;
+    std::string_view varName2;
+    std::string_view varName3;
+
+    while (lines_generated_ < lines_of_code_ && static_cast<int>(commands.size()) < COMMAND_CHUNK_SIZE)
+    {
+        std::uniform_int_distribution<> cmd_type(0, 5);  // 6 possible commands: 0-5
+        int choice = cmd_type(gen_);
+
+        // DECLARE, DECLARE, ADD/SUBTRACT takes three lines; keep the total exact
+        if ((choice == 2 || choice == 3) && lines_of_code_ - lines_generated_ < 3)
+        {
+            choice = 1;
+        }
+
+        const ICommand* cmd = nullptr;
+
+        switch (choice)
+        {
+        case 0:
+            cmd = arena_.create<PrintCommand>(PrintCommand::GREETING);
+            break;
+
+        case 1:
+            varName = nextVarName();
+            int16 = value_uint16(gen_);
+            cmd = arena_.create<DeclareCommand>(varName, int16);
+            break;
+
+        case 2:
+        case 3:
+            varName = nextVarName();
+
+            int16 = value_uint16(gen_);
+            varName2 = nextVarName();
+            commands.push_back(arena_.create<DeclareCommand>(varName2, int16));
+
+            int16 = value_uint16(gen_);
+            varName3 = nextVarName();
+            commands.push_back(arena_.create<DeclareCommand>(varName3, int16));
+            lines_generated_ += 2;
+
+            if (choice == 2)
+                cmd = arena_.create<AddCommand>(varName, varName2, varName3);
+            else
+                cmd = arena_.create<SubtractCommand>(varName, varName2, varName3);
+            break;
+
+        case 4:
+            X = static_cast<uint8_t>(value_uint8(gen_));
+            cmd = arena_.create<SleepCommand>(X);
+            break;
+
+        case 5:
+            int repeat_count = value_uint8(gen_) % 5 + 1;
+            int inner_cmd_count = value_uint8(gen_) % 3 + 1;
+            std::vector<const ICommand*> loop;
+            int loop_count = chunk.loop_count;
+            int loop_lines = generateLoop(repeat_count, inner_cmd_count, 1, chunk, loop);
+            if (loop_lines <= lines_of_code_ - lines_generated_)
+            {
+                commands.insert(commands.end(), loop.begin(), loop.end());
+                lines_generated_ += loop_lines;
+                continue;
+            }
+
+            // Every iteration counts toward the program length; a loop that
+            // doesn't fit in what is left becomes a DECLARE
+            chunk.loop_count = loop_count;
+            varName = nextVarName();
+            int16 = value_uint16(gen_);
+            cmd = arena_.create<DeclareCommand>(varName, int16);
+            break;
+        }
+        commands.push_back(cmd);
+        lines_generated_++;
+    }
+
+    next_base_ += static_cast<int>(commands.size());
+
+    if (fuse_instructions_)
+    {
+        fuseSuperinstructions(commands);
+    }
+}
+
+void ProgramImage::fuseSuperinstructions(std::vector<const ICommand*>& commands)
+{
+    // Peephole pass over the chunk. The fused command takes the triple's
+    // first slot; the other two stay in place so slot indices keep matching
+    // instruction lines, and are skipped by the counter.
+    for (size_t i = 0; i + 2 < commands.size(); ++i)
+    {
+        const ICommand* first = commands[i];
+        const ICommand* second = commands[i + 1];
+        const ICommand* third = commands[i + 2];
+        if (first->getCommandType() != ICommand::DECLARE || second->getCommandType() != ICommand::DECLARE)
+        {
+            continue;
+        }
+
+        std::string_view lhs = static_cast<const DeclareCommand*>(first)->getVarName();
+        std::string_view rhs = static_cast<const DeclareCommand*>(second)->getVarName();
+        bool fusable = (third->getCommandType() == ICommand::ADD && static_cast<const AddCommand*>(third)->readsOperands(lhs, rhs))
+            || (third->getCommandType() == ICommand::SUBTRACT && static_cast<const SubtractCommand*>(third)->readsOperands(lhs, rhs));
+        if (!fusable)
+        {
+            continue;
+        }
+
+        commands[i] = arena_.create<FusedArithmeticCommand>(first, second, third);
+        i += FusedArithmeticCommand::LINES - 1;
+    }
+}
+
+int ProgramImage::generateLoop(int repeats, int body_count, int depth, Chunk& chunk, std::vector<const ICommand*>& stream)
+{
+    // Lowered as: head (loop counter), body, back-edge to the head
+    const ForCommand* head = arena_.create<ForCommand>(repeats, chunk.loop_count++);
+    int head_slot = static_cast<int>(stream.size());
+    stream.push_back(head);
+
+    int body_lines = generateRandomCommands(body_count, depth, chunk, stream);
+
+    int back_edge_slot = static_cast<int>(stream.size());
+    stream.push_back(arena_.create<EndForCommand>(head, head_slot - back_edge_slot));
+    return repeats * (body_lines + 2);
+}
+
+int ProgramImage::generateRandomCommands(int count, int depth, Chunk& chunk, std::vector<const ICommand*>& stream)
+{
+    std::uniform_int_distribution<> cmd_type(0, 5); // same 6 types
+    std::uniform_int_distribution<uint16_t> value_uint16(0, 65535);
+    std::uniform_int_distribution<int> value_uint8(0, 255);
+    int lines = 0;
+
+    for (int i = 0; i < count; ++i)
+    {
+        ICommand* cmd = nullptr;
+        int choice = cmd_type(gen_);
+
+        switch (choice)
+        {
+        case 0:
+        {
+            cmd = arena_.create<PrintCommand>(PrintCommand::GREETING);
+            break;
+        }
+        case 1:
+        {
+            std::string_view varName = nextVarName();
+            uint16_t value = value_uint16(gen_);
+            cmd = arena_.create<DeclareCommand>(varName, value);
+            break;
+        }
+        case 2:
+        case 3:
+        {
+            std::string_view varName = nextVarName();
+            std::string_view var2Name = nextVarName();
+            std::string_view var3Name = nextVarName();
+
+            auto d1 = arena_.create<DeclareCommand>(var2Name, value_uint16(gen_));
+            auto d2 = arena_.create<DeclareCommand>(var3Name, value_uint16(gen_));
+            d1->setSubcommandLevel(depth);
+            d2->setSubcommandLevel(depth);
+            stream.push_back(d1);
+            stream.push_back(d2);
+            lines += 2;
+
+            if (choice == 2)
+                cmd = arena_.create<AddCommand>(varName, var2Name, var3Name);
+            else
+                cmd = arena_.create<SubtractCommand>(varName, var2Name, var3Name);
+            break;
+        }
+        case 4:
+        {
+            uint8_t ticks = static_cast<uint8_t>(value_uint8(gen_));
+            cmd = arena_.create<SleepCommand>(ticks);
+            break;
+        }
+        case 5:
+        {
+            if (depth < 3)
+            {
+                int repeats = value_uint8(gen_) % 5 + 1;
+                int nested_count = value_uint8(gen_) % 3 + 1;
+                lines += generateLoop(repeats, nested_count, depth + 1, chunk, stream);
+            }
+            continue;
+        }
+        }
+
+        if (cmd)
+        {
+            cmd->setSubcommandLevel(depth);
+            stream.push_back(cmd);
+            lines++;
+        }
+    }
+
+    return lines;
+}
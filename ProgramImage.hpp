@@ -0,0 +1,73 @@
+#ifndef PROGRAM_IMAGE_H
+#define PROGRAM_IMAGE_H
+
+#include "ICommand.hpp"
+#include "CommandArena.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <random>
+#include <string_view>
+#include <vector>
+
+// Immutable instruction stream for one generated program. The program is
+// produced lazily, COMMAND_CHUNK_SIZE slots at a time, from the seed; the
+// commands and their constant strings live in the image's arena.
+//
+// A shared image (handed out by ProgramCache) keeps every chunk so any
+// number of processes can run it at their own pace. A private image has a
+// single reader and drops each chunk once the next one is generated.
+class ProgramImage
+{
+public:
+    static constexpr int COMMAND_CHUNK_SIZE = 64;
+
+    struct Chunk
+    {
+        // Flat-program slot of commands[0]
+        int base;
+        std::vector<const ICommand*> commands;
+        // FOR loops in this chunk; their ids index the context's counters
+        int loop_count;
+    };
+
+    ProgramImage(uint32_t seed, int min_ins, int max_ins, bool fuse_instructions, bool shared);
+    ProgramImage(const ProgramImage&) = delete;
+    ProgramImage& operator=(const ProgramImage&) = delete;
+
+    // Chunk number index, generated on first request; nullptr past the end
+    // of the program
+    const Chunk* getChunk(int index);
+    int getLinesOfCode() const;
+    // Length of the program the constructor would build, without building it
+    static int programLength(uint32_t seed, int min_ins, int max_ins);
+    uint32_t getSeed() const;
+    bool isShared() const;
+
+private:
+    uint32_t seed_;
+    bool fuse_instructions_;
+    bool shared_;
+    int lines_of_code_ = 0;
+
+    std::mutex mutex_;
+    std::minstd_rand gen_;
+    CommandArena arena_;
+    std::deque<Chunk> chunks_;
+    // Chunk number of chunks_.front(); advances as a private image drops
+    // retired chunks
+    int first_chunk_ = 0;
+    int next_base_ = 0;
+    int lines_generated_ = 0;
+    int var_counter_ = 0;
+
+    static int drawLength(std::minstd_rand& gen, int min_ins, int max_ins);
+    void generateNextChunk();
+    int generateRandomCommands(int count, int depth, Chunk& chunk, std::vector<const ICommand*>& stream);
+    int generateLoop(int repeats, int body_count, int depth, Chunk& chunk, std::vector<const ICommand*>& stream);
+    void fuseSuperinstructions(std::vector<const ICommand*>& commands);
+    std::string_view nextVarName();
+};
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef ST_H
 #define ST_H
 
+#include <cstdint>
 #include <string>
 
 class ST {
@@ -14,12 +15,22 @@ public:
 
     DataType type = DataType::INT;
     std::string value = "";
+    // UINT16 entries keep their value here, not in value
+    uint16_t number = 0;
 
     ST() = default;
 
     ST(DataType type, const std::string& value)
         : type(type), value(value) {
     }
+
+    explicit ST(uint16_t number)
+        : type(DataType::UINT16), number(number) {
+    }
+
+    std::string text() const {
+        return type == DataType::UINT16 ? std::to_string(number) : value;
+    }
 };
 
 #endif
\ No newline at end of file
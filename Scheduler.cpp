@@ -4,6 +4,11 @@
 #include "Clock.hpp"
 #include "Globals.hpp"
 #include "ProcessManager.hpp"
+#include "FIFOReadyQueue.hpp"
+#include "MLFQReadyQueue.hpp"
+#include "ShortestJobReadyQueue.hpp"
+#include "DeadlineReadyQueue.hpp"
+#include "ThreadAffinity.hpp"
 
 #include <iostream>
 #include <chrono>
@@ -13,11 +18,55 @@
 #include <string>
 #include <ctime>
 #include <atomic>
+#include <algorithm>
+#include <limits>
 
 Scheduler::Scheduler(std::string scheduler_algo, int delays_per_exec, int n_cpu, int quantum_cycle, Clock* cpu_clock, IMemoryAllocator* memory_allocator)
     : is_running(false), active_threads_(0), ready_threads(0), scheduler_algorithm(scheduler_algo), delay_per_execution(delays_per_exec),
-    cpu_count(n_cpu), quantum_cycle(quantum_cycle), cpu_clock(cpu_clock), memory_allocator_(memory_allocator)
+    cpu_count(n_cpu), quantum_cycle(quantum_cycle), cpu_clock(cpu_clock), memory_allocator_(memory_allocator), ready_queue_(nullptr)
 {
+    createReadyQueue();
+}
+
+Scheduler::~Scheduler()
+{
+    delete ready_queue_;
+}
+
+void Scheduler::createReadyQueue()
+{
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    delete ready_queue_;
+
+    if (scheduler_algorithm == "mlfq")
+    {
+        std::vector<int> quanta = mlfq_quanta_;
+        if (quanta.empty())
+        {
+            // Default: three levels, doubling the RR quantum at each level
+            for (int i = 0; i < 3; ++i)
+            {
+                quanta.push_back(quantum_cycle << i);
+            }
+        }
+        ready_queue_ = new MLFQReadyQueue(quanta, mlfq_boost_ticks_, cpu_clock);
+    }
+    else if (scheduler_algorithm == "sjf" || scheduler_algorithm == "srtf")
+    {
+        ready_queue_ = new ShortestJobReadyQueue(quantum_cycle, aging_rate_, cpu_clock);
+    }
+    else if (scheduler_algorithm == "edf")
+    {
+        ready_queue_ = new DeadlineReadyQueue(quantum_cycle);
+    }
+    else if (scheduler_algorithm == "rr")
+    {
+        ready_queue_ = new FIFOReadyQueue(quantum_cycle, affinity_window_, hard_pinning_);
+    }
+    else
+    {
+        ready_queue_ = new FIFOReadyQueue(quantum_cycle);
+    }
 }
 
 void Scheduler::addProcess(std::shared_ptr<Process> process)
@@ -27,14 +76,25 @@ void Scheduler::addProcess(std::shared_ptr<Process> process)
         startMemoryLog();
     }
 
+    process->setArrivalTick(cpu_clock->getCpuClock());
+    process->setArrivalNs(nowNs());
+    markReady(process, process->getArrivalTick());
+    trace_.record(process->getArrivalTick(), 0, process->getPID(), SchedulerTrace::ARRIVE);
+
     std::unique_lock<std::mutex> lock(queue_mutex_);
-    process_queue_.push(process);
-    queue_condition_.notify_one();
+    if (lookahead_ticks_ > 0)
+    {
+        postEvent(process->getArrivalTick(), process, PendingEvent::ARRIVE);
+        return;
+    }
+    ready_queue_->push(process);
+    notifyQueue();
 }
 
 void Scheduler::setAlgorithm(const std::string& algorithm)
 {
     scheduler_algorithm = algorithm;
+    createReadyQueue();
 }
 
 void Scheduler::setNumCPUs(int num)
@@ -43,382 +103,1446 @@ void Scheduler::setNumCPUs(int num)
     CoreStateManager::getInstance().initialize(cpu_count);
 }
 
-void Scheduler::setDelays(int delay)
+void Scheduler::setDelays(int delay)
+{
+    delay_per_execution = delay;
+}
+
+void Scheduler::setCPUClock(Clock* clock)
+{
+    cpu_clock = clock;
+}
+
+void Scheduler::setTraceFile(const std::string& path)
+{
+    trace_.enableRecording(path);
+}
+
+bool Scheduler::loadReplay(const std::string& path)
+{
+    return trace_.loadReplay(path);
+}
+
+SchedulerTrace& Scheduler::getTrace()
+{
+    return trace_;
+}
+
+void Scheduler::setQuantumCycle(int quantum_cycle)
+{
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    this->quantum_cycle = quantum_cycle;
+    ready_queue_->setQuantum(quantum_cycle);
+}
+
+void Scheduler::setAdaptiveQuantum(int min_quantum, int max_quantum, int period_ticks)
+{
+    adaptive_quantum_ = true;
+    quantum_min_ = std::max(1, min_quantum);
+    quantum_max_ = std::max(quantum_min_, max_quantum);
+    adapt_period_ticks_ = std::max(1, period_ticks);
+    setQuantumCycle(std::clamp(quantum_cycle, quantum_min_, quantum_max_));
+}
+
+void Scheduler::setCoroutineMode(bool enabled)
+{
+    coroutine_mode_ = enabled;
+}
+
+void Scheduler::setWorkerPool(int workers, bool lockstep)
+{
+    // Virtual cores are stepped as coroutines by a fixed pool of workers
+    coroutine_mode_ = true;
+    pool_workers_ = workers > 0 ? workers : std::max(1u, std::thread::hardware_concurrency());
+    tick_lockstep_ = lockstep;
+}
+
+void Scheduler::setPDES(int workers, int lookahead)
+{
+    // Pool workers, but each virtual core keeps its own clock
+    setWorkerPool(workers, false);
+    lookahead_ticks_ = std::max(1, lookahead);
+}
+
+void Scheduler::setBatchedArithmetic(bool enabled)
+{
+    batched_arithmetic_ = enabled;
+}
+
+int Scheduler::getLookahead() const
+{
+    return lookahead_ticks_;
+}
+
+int Scheduler::getWorkerPoolSize() const
+{
+    return pool_workers_;
+}
+
+void Scheduler::setInstructionsPerTick(int instructions)
+{
+    instructions_per_tick_ = std::max(1, instructions);
+}
+
+std::vector<double> Scheduler::getCoreThroughput()
+{
+    // Instructions retired per wall-clock second since the scheduler started
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time_).count();
+    std::vector<double> throughput;
+    for (int i = 0; i < cpu_count; ++i)
+    {
+        throughput.push_back(seconds > 0 ? core_instructions_[i].load() / seconds : 0.0);
+    }
+    return throughput;
+}
+
+int Scheduler::getCurrentQuantum()
+{
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return quantum_cycle;
+}
+
+long long Scheduler::getQuantumAdjustments() const
+{
+    return quantum_adjustments_.load();
+}
+
+void Scheduler::setMLFQ(const std::vector<int>& quanta, int boost_ticks)
+{
+    mlfq_quanta_ = quanta;
+    mlfq_boost_ticks_ = boost_ticks;
+    createReadyQueue();
+}
+
+void Scheduler::setAgingRate(double aging_rate)
+{
+    aging_rate_ = aging_rate;
+    createReadyQueue();
+}
+
+void Scheduler::setAffinity(int window, bool hard_pinning)
+{
+    affinity_window_ = window;
+    hard_pinning_ = hard_pinning;
+    createReadyQueue();
+}
+
+void Scheduler::setSwitchCosts(int same_process, int same_core, int migration)
+{
+    switch_cost_[SWITCH_SAME_PROCESS] = std::max(0, same_process);
+    switch_cost_[SWITCH_SAME_CORE] = std::max(0, same_core);
+    switch_cost_[SWITCH_MIGRATION] = std::max(0, migration);
+    switch_costs_configured_ = true;
+}
+
+void Scheduler::getSwitchStats(std::vector<long long>& counts, std::vector<long long>& ticks)
+{
+    counts.clear();
+    ticks.clear();
+    for (int i = 0; i < SWITCH_KINDS; ++i)
+    {
+        counts.push_back(switch_count_[i].load());
+        ticks.push_back(switch_ticks_[i].load());
+    }
+}
+
+const char* Scheduler::switchKindName(SwitchKind kind)
+{
+    switch (kind)
+    {
+    case SWITCH_SAME_PROCESS: return "same-process";
+    case SWITCH_SAME_CORE: return "same-core";
+    case SWITCH_MIGRATION: return "migration";
+    default: return "unknown";
+    }
+}
+
+long long Scheduler::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Scheduler::markReady(const std::shared_ptr<Process>& process, int tick)
+{
+    process->setReadyTime(tick, nowNs());
+}
+
+int Scheduler::localTick(int core_id) const
+{
+    // Under PDES a core's local clock can run ahead of the published tick
+    if (lookahead_ticks_ > 0)
+    {
+        return virtual_cores_[core_id - 1]->stepped_tick.load();
+    }
+    return cpu_clock->getCpuClock();
+}
+
+void Scheduler::requeueProcess(const std::shared_ptr<Process>& process, int core_id, bool used_full_quantum)
+{
+    int tick = localTick(core_id);
+    markReady(process, tick);
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    if (lookahead_ticks_ > 0)
+    {
+        postEvent(tick, process, used_full_quantum ? PendingEvent::READY_EXPIRED : PendingEvent::READY);
+        return;
+    }
+    ready_queue_->requeue(process, used_full_quantum);
+}
+
+void Scheduler::postEvent(int tick, const std::shared_ptr<Process>& process, PendingEvent::Kind kind)
+{
+    pending_events_.push({ tick, event_sequence_++, process, kind });
+}
+
+void Scheduler::releaseEvents(int floor)
+{
+    // Every core has reached floor, so nobody can see these in its past
+    std::vector<std::shared_ptr<Process>> freed;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        while (!pending_events_.empty() && pending_events_.top().tick <= floor)
+        {
+            const PendingEvent& event = pending_events_.top();
+            // onCoreRetired only sees processes already in the ready queue;
+            // one still pending here may be pinned to a core removed since
+            if (event.process->getCPUCoreID() > cpu_count)
+            {
+                event.process->setCPUCoreID(-1);
+            }
+            switch (event.kind)
+            {
+            case PendingEvent::ARRIVE: ready_queue_->push(event.process); break;
+            case PendingEvent::READY: ready_queue_->requeue(event.process, false); break;
+            case PendingEvent::READY_EXPIRED: ready_queue_->requeue(event.process, true); break;
+            case PendingEvent::FREE: freed.push_back(event.process); break;
+            }
+            pending_events_.pop();
+        }
+    }
+
+    for (auto& process : freed)
+    {
+        memory_allocator_->deallocate(process);
+        process->setMemory(nullptr);
+    }
+}
+
+void Scheduler::advanceFloor()
+{
+    int floor = std::numeric_limits<int>::max();
+    int cores = cpu_count;
+    for (int i = 0; i < cores; ++i)
+    {
+        const VirtualCore& core = *virtual_cores_[i];
+        if (!core.retired)
+        {
+            floor = std::min(floor, core.stepped_tick.load());
+        }
+    }
+
+    int current = pdes_floor_.load();
+    if (floor == std::numeric_limits<int>::max() || floor <= current)
+    {
+        return;
+    }
+    if (pdes_floor_.compare_exchange_strong(current, floor))
+    {
+        releaseEvents(floor);
+        cpu_clock->advanceWindow(floor);
+    }
+}
+
+void Scheduler::initCore(int core_id)
+{
+    if (!core_latency_[core_id - 1])
+    {
+        core_latency_[core_id - 1] = std::make_unique<CoreLatency>();
+    }
+
+    if (!virtual_cores_[core_id - 1])
+    {
+        virtual_cores_[core_id - 1] = std::make_unique<VirtualCore>();
+        virtual_cores_[core_id - 1]->core_id = core_id;
+    }
+    virtual_cores_[core_id - 1]->retired = false;
+    // A new core starts at the published tick, never behind the cores already running
+    virtual_cores_[core_id - 1]->stepped_tick = cpu_clock->getCpuClock();
+}
+
+LatencyHistogram& Scheduler::latency(int core_id, LatencyMetric metric)
+{
+    return core_latency_[core_id - 1]->metrics[metric];
+}
+
+void Scheduler::mergeLatency(LatencyMetric metric, LatencyHistogram& merged)
+{
+    std::lock_guard<std::mutex> lock(cores_mutex_);
+    merged.clear();
+    for (const auto& core : core_latency_)
+    {
+        if (core)
+        {
+            merged.merge(core->metrics[metric]);
+        }
+    }
+}
+
+const char* Scheduler::latencyMetricName(LatencyMetric metric)
+{
+    switch (metric)
+    {
+    case LATENCY_WAIT_TICKS: return "ready wait (ticks)";
+    case LATENCY_WAIT_NS: return "ready wait (ns)";
+    case LATENCY_RESPONSE_TICKS: return "response (ticks)";
+    case LATENCY_RESPONSE_NS: return "response (ns)";
+    case LATENCY_TURNAROUND_TICKS: return "turnaround (ticks)";
+    case LATENCY_TURNAROUND_NS: return "turnaround (ns)";
+    case LATENCY_QUANTUM_UTILIZATION: return "quantum used (%)";
+    default: return "unknown";
+    }
+}
+
+std::vector<long long> Scheduler::getCoreMigrations()
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return core_migrations_;
+}
+
+void Scheduler::getTurnaroundStats(double& mean, int& p50, int& p99, size_t& count)
+{
+    std::vector<int> samples;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        samples = turnaround_samples_;
+    }
+
+    count = samples.size();
+    mean = 0.0;
+    p50 = 0;
+    p99 = 0;
+    if (samples.empty())
+    {
+        return;
+    }
+
+    long long total = 0;
+    for (int sample : samples)
+    {
+        total += sample;
+    }
+    mean = static_cast<double>(total) / samples.size();
+
+    std::sort(samples.begin(), samples.end());
+    p50 = samples[(samples.size() - 1) * 50 / 100];
+    p99 = samples[(samples.size() - 1) * 99 / 100];
+}
+
+void Scheduler::getDeadlineStats(long long& met, long long& missed, std::vector<long long>& lateness_histogram)
+{
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    met = deadlines_met_;
+    missed = deadlines_missed_;
+    lateness_histogram = lateness_histogram_;
+}
+
+const std::string& Scheduler::getAlgorithm() const
+{
+    return scheduler_algorithm;
+}
+
+std::vector<size_t> Scheduler::getQueueLevelSizes()
+{
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    return ready_queue_->getLevelSizes();
+}
+
+double Scheduler::getMeanResponseTime() const
+{
+    long long count = response_count_.load();
+    return count > 0 ? static_cast<double>(response_time_total_.load()) / count : 0.0;
+}
+
+void Scheduler::recordDispatch(const std::shared_ptr<Process>& process, int core_id)
+{
+    int tick = localTick(core_id);
+
+    // getCPUCoreID still holds the core of the previous dispatch here
+    int last_core = process->getCPUCoreID();
+    if (last_core >= 1 && last_core != core_id)
+    {
+        process->incrementMigrationCount();
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        if (core_migrations_.size() < static_cast<size_t>(core_id))
+        {
+            core_migrations_.resize(core_id, 0);
+        }
+        core_migrations_[core_id - 1]++;
+    }
+
+    long long ns = nowNs();
+    latency(core_id, LATENCY_WAIT_TICKS).record(std::max(0, tick - process->getReadyTick()));
+    latency(core_id, LATENCY_WAIT_NS).record(std::max(0LL, ns - process->getReadyNs()));
+
+    if (process->getFirstDispatchTick() < 0)
+    {
+        process->setFirstDispatchTick(tick);
+        response_time_total_ += tick - process->getArrivalTick();
+        response_count_++;
+        latency(core_id, LATENCY_RESPONSE_TICKS).record(std::max(0, tick - process->getArrivalTick()));
+        latency(core_id, LATENCY_RESPONSE_NS).record(std::max(0LL, ns - process->getArrivalNs()));
+    }
+
+    trace_.record(tick, core_id, process->getPID(), SchedulerTrace::DISPATCH);
+    trace_.advanceReplay(core_id);
+}
+
+int Scheduler::chargeSwitch(const std::shared_ptr<Process>& process, int core_id)
+{
+    // Called before setCPUCoreID, so getCPUCoreID is still the previous core
+    SwitchKind kind = SWITCH_SAME_CORE;
+    int last_core = process->getCPUCoreID();
+    long long last_pid = last_pid_on_core_[core_id - 1];
+    last_pid_on_core_[core_id - 1] = process->getPID();
+    if (last_pid == -1)
+    {
+        // First dispatch on this core; there is no outgoing context to save
+        return 0;
+    }
+
+    if (last_pid == static_cast<long long>(process->getPID()))
+    {
+        kind = SWITCH_SAME_PROCESS;
+    }
+    else if (last_core >= 1 && last_core != core_id)
+    {
+        kind = SWITCH_MIGRATION;
+    }
+
+    int cost = switch_costs_configured_ || isTimeSliced() ? switch_cost_[kind] : 0;
+    switch_count_[kind]++;
+    switch_ticks_[kind] += cost;
+    return cost;
+}
+
+void Scheduler::waitTicks(int ticks, int core_id)
+{
+    if (ticks <= 0)
+    {
+        return;
+    }
+
+    int tick = cpu_clock->getCpuClock();
+    int target = tick + ticks;
+    while (tick < target && is_running && !GLOBAL_SHUTTING_DOWN && !isRetiring(core_id))
+    {
+        tick = cpu_clock->waitForTick(tick);
+    }
+}
+
+void Scheduler::adaptQuantum()
+{
+    int tick = cpu_clock->getCpuClock();
+    if (tick < next_adapt_tick_)
+    {
+        return;
+    }
+
+    // One core evaluates each window; the rest carry on
+    std::unique_lock<std::mutex> adapt_lock(adapt_mutex_, std::try_to_lock);
+    if (!adapt_lock.owns_lock() || tick < next_adapt_tick_)
+    {
+        return;
+    }
+    next_adapt_tick_ = tick + adapt_period_ticks_;
+
+    int elapsed = tick - last_adapt_tick_;
+    long long switch_ticks = 0;
+    for (int i = 0; i < SWITCH_KINDS; ++i)
+    {
+        switch_ticks += switch_ticks_[i].load();
+    }
+    long long response_total = response_time_total_.load();
+    long long response_count = response_count_.load();
+
+    int cores = std::max(1, cpu_count.load());
+    double switch_fraction = elapsed > 0
+        ? static_cast<double>(switch_ticks - last_switch_ticks_) / (static_cast<double>(elapsed) * cores)
+        : 0.0;
+    double window_response = response_count > last_response_count_
+        ? static_cast<double>(response_total - last_response_total_) / (response_count - last_response_count_)
+        : last_window_response_;
+
+    size_t queue_length;
+    int quantum;
+    {
+        std::lock_guard<std::mutex> lock(queue_mutex_);
+        queue_length = ready_queue_->size();
+        quantum = quantum_cycle;
+    }
+    double queued_per_core = static_cast<double>(queue_length) / cores;
+
+    // Longer slices when switching eats the cores, shorter ones when a backlog
+    // is building and new arrivals are waiting longer to first run.
+    int step = std::max(1, quantum / 4);
+    int new_quantum = quantum;
+    if (switch_fraction > 0.10)
+    {
+        new_quantum = quantum + step;
+    }
+    else if (queued_per_core >= 1.0 && last_window_response_ >= 0 && window_response > last_window_response_ * 1.1)
+    {
+        new_quantum = quantum - step;
+    }
+    else if (queued_per_core < 1.0 && switch_fraction > 0.02)
+    {
+        new_quantum = quantum + step;
+    }
+    new_quantum = std::clamp(new_quantum, quantum_min_, quantum_max_);
+
+    if (new_quantum != quantum)
+    {
+        setQuantumCycle(new_quantum);
+        quantum_adjustments_++;
+
+        std::lock_guard<std::mutex> lock(log_mutex_);
+        std::filesystem::create_directories("outputs");
+        std::ofstream log("outputs/quantum-adapt.txt", std::ios::app);
+        log << "tick " << tick << ": quantum " << quantum << " -> " << new_quantum
+            << " (queued " << queue_length << ", switch fraction " << std::fixed << std::setprecision(3) << switch_fraction
+            << ", response " << std::setprecision(1) << window_response << " ticks)\n";
+    }
+
+    last_adapt_tick_ = tick;
+    last_switch_ticks_ = switch_ticks;
+    last_response_total_ = response_total;
+    last_response_count_ = response_count;
+    last_window_response_ = window_response;
+}
+
+void Scheduler::recordFinish(const std::shared_ptr<Process>& process, int core_id)
+{
+    int tick = localTick(core_id);
+    latency(core_id, LATENCY_TURNAROUND_TICKS).record(std::max(0, tick - process->getArrivalTick()));
+    latency(core_id, LATENCY_TURNAROUND_NS).record(std::max(0LL, nowNs() - process->getArrivalNs()));
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        turnaround_samples_.push_back(tick - process->getArrivalTick());
+
+        if (process->hasDeadline())
+        {
+            int lateness = tick - process->getDeadlineTick();
+            int bucket = 0;
+            if (lateness <= 0)
+            {
+                deadlines_met_++;
+            }
+            else
+            {
+                deadlines_missed_++;
+                while (bucket < LATENESS_BUCKETS - 1 && (1 << bucket) <= lateness)
+                {
+                    bucket++;
+                }
+            }
+            lateness_histogram_[bucket]++;
+        }
+    }
+
+    trace_.record(tick, core_id, process->getPID(), SchedulerTrace::FINISH);
+}
+
+int Scheduler::getNumCPUs() const
+{
+    return cpu_count.load();
+}
+
+bool Scheduler::isRetiring(int core_id) const
+{
+    return core_retiring_[core_id - 1].load();
+}
+
+int Scheduler::addCores(int count)
+{
+    std::lock_guard<std::mutex> resize_lock(resize_mutex_);
+    std::lock_guard<std::mutex> lock(cores_mutex_);
+    for (int i = 0; i < count && cpu_count < MAX_CORES; ++i)
+    {
+        int core_id = cpu_count + 1;
+        core_retiring_[core_id - 1] = false;
+        last_pid_on_core_[core_id - 1] = -1;
+        core_instructions_[core_id - 1] = 0;
+        initCore(core_id);
+        CoreStateManager::getInstance().initialize(core_id);
+        cpu_count++;
+        if (is_running && pool_workers_ == 0)
+        {
+            worker_threads_.emplace_back(&Scheduler::run, this, core_id);
+            pinWorker(worker_threads_.size() - 1);
+        }
+    }
+    return cpu_count;
+}
+
+int Scheduler::removeCores(int count)
+{
+    std::lock_guard<std::mutex> resize_lock(resize_mutex_);
+    std::unique_lock<std::mutex> lock(cores_mutex_);
+    for (int i = 0; i < count && cpu_count > 1; ++i)
+    {
+        // Retire the highest-numbered core so core ids stay contiguous. The
+        // worker preempts its process at the next instruction boundary.
+        int core_id = cpu_count;
+        core_retiring_[core_id - 1] = true;
+        queue_condition_.notify_all();
+
+        if (is_running && pool_workers_ > 0)
+        {
+            // A pool worker flushes the core on its next tick
+            VirtualCore& core = *virtual_cores_[core_id - 1];
+            lock.unlock();
+            {
+                // No timeout: counting the core out before it is flushed would
+                // strand its process. stop() wakes this wait as well.
+                std::unique_lock<std::mutex> retire_lock(retire_mutex_);
+                retire_condition_.wait(retire_lock, [&]
+                    {
+                        return core.retired.load() || !is_running;
+                    });
+            }
+            lock.lock();
+        }
+        else if (is_running && !worker_threads_.empty())
+        {
+            // Join without cores_mutex_ so stats readers aren't blocked
+            // behind the worker's last instruction
+            std::thread worker = std::move(worker_threads_.back());
+            worker_threads_.pop_back();
+            worker_host_cpu_.pop_back();
+            lock.unlock();
+            if (worker.joinable())
+            {
+                worker.join();
+            }
+            lock.lock();
+        }
+
+        cpu_count--;
+        CoreStateManager::getInstance().initialize(cpu_count);
+
+        std::lock_guard<std::mutex> qlock(queue_mutex_);
+        ready_queue_->onCoreRetired(core_id);
+    }
+    queue_condition_.notify_all();
+    return cpu_count;
+}
+
+void Scheduler::setWorkerCpus(const std::vector<int>& host_cpus)
+{
+    worker_cpus_ = host_cpus;
+}
+
+std::vector<int> Scheduler::getWorkerAffinity()
+{
+    std::lock_guard<std::mutex> lock(cores_mutex_);
+    return worker_host_cpu_;
+}
+
+void Scheduler::pinWorker(size_t index)
+{
+    // Workers take the configured host CPUs round-robin
+    int host_cpu = -1;
+    if (!worker_cpus_.empty())
+    {
+        std::string error;
+        int wanted = worker_cpus_[index % worker_cpus_.size()];
+        if (ThreadAffinity::pin(worker_threads_[index], wanted, error))
+        {
+            host_cpu = wanted;
+        }
+        else
+        {
+            std::cerr << "[WARNING] Worker " << index << ": " << error << std::endl;
+        }
+    }
+    worker_host_cpu_.resize(worker_threads_.size(), -1);
+    worker_host_cpu_[index] = host_cpu;
+}
+
+void Scheduler::start()
+{
+    is_running = true;
+    start_time_ = std::chrono::steady_clock::now();
+    expected_threads_ = pool_workers_ > 0 ? pool_workers_ : cpu_count.load();
+    if (pool_workers_ > 0 && tick_lockstep_)
+    {
+        cpu_clock->enableLockstep(pool_workers_);
+    }
+    for (int i = 1; i <= cpu_count; ++i)
+    {
+        initCore(i);
+    }
+    if (lookahead_ticks_ > 0)
+    {
+        pdes_floor_ = cpu_clock->getCpuClock();
+        cpu_clock->enableWindow(lookahead_ticks_, pdes_floor_);
+    }
+
+    for (int i = 0; i < expected_threads_; ++i)
+    {
+        if (pool_workers_ > 0)
+        {
+            worker_threads_.emplace_back(&Scheduler::runPool, this, i);
+        }
+        else
+        {
+            worker_threads_.emplace_back(&Scheduler::run, this, i + 1);
+        }
+        pinWorker(i);
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(start_mutex_);
+        start_condition_.wait(lock, [this]
+            {
+                return ready_threads == expected_threads_;
+            });
+        started_ = true;
+    }
+    start_condition_.notify_all();
+}
+
+void Scheduler::waitUntilStarted()
+{
+    // start() runs on the process manager's thread
+    std::unique_lock<std::mutex> lock(start_mutex_);
+    start_condition_.wait(lock, [this]
+        {
+            return started_;
+        });
+}
+
+void Scheduler::startMemoryLog()
+{
+    memory_log_ = true;
+    memory_logging_thread_ = std::thread([this]()
+        {
+            int last_clock = cpu_clock->getCpuClock();
+
+            while (is_running)
+            {
+                // Wait for CPU clock tick increment
+                last_clock = cpu_clock->waitForTick(last_clock);
+
+                bool any_core_active = false;
+
+                // Check if any core is active
+                for (int i = 1; i <= cpu_count; ++i)
+                {
+                    if (CoreStateManager::getInstance().getCoreState(i))
+                    {
+                        any_core_active = true;
+                        break;
+                    }
+                }
+
+                // Increment active CPU count if at least one core is active
+                if (any_core_active)
+                {
+                    cpu_clock->incrementActiveCpuNum();
+                }
+            }
+        });
+}
+
+void Scheduler::stop()
+{
+    {
+        std::lock_guard<std::mutex> retire_lock(retire_mutex_);
+        is_running = false;
+    }
+    retire_condition_.notify_all();
+
+    // Workers blocked on the clock wake at the next tick
+    queue_condition_.notify_all();
+    if (lookahead_ticks_ > 0)
+    {
+        // Let the clock tick on without waiting for the cores
+        cpu_clock->disableWindow();
+    }
+
+    std::lock_guard<std::mutex> lock(cores_mutex_);
+    for (auto& thread : worker_threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+
+    if (memory_logging_thread_.joinable())
+    {
+        memory_logging_thread_.join();
+    }
+
+    trace_.save();
+
+    std::cout << "Scheduler fully stopped.\n";
+}
+
+void Scheduler::clearQueue()
+{
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    ready_queue_->clear();
+}
+
+std::shared_ptr<Process> Scheduler::takeProcess(int core_id, bool block)
+{
+    std::unique_lock<std::mutex> lock(queue_mutex_);
+
+    while (is_running && !isRetiring(core_id))
+    {
+        size_t expected_pid;
+        int expected_tick;
+        if (trace_.isReplaying() && trace_.getExpected(core_id, expected_pid, expected_tick))
+        {
+            // Replay: this core may only take the process it dispatched next in the trace.
+            std::shared_ptr<Process> process = ready_queue_->remove(expected_pid);
+            if (process)
+            {
+                return process;
+            }
+
+            if (cpu_clock->getCpuClock() > expected_tick + SchedulerTrace::REPLAY_SLACK_TICKS)
+            {
+                std::cerr << "[WARNING] Replay diverged on core " << core_id << " waiting for pid " << expected_pid << std::endl;
+                trace_.abandonReplay(core_id);
+                continue;
+            }
+
+            if (!block)
+            {
+                return nullptr;
+            }
+            queue_condition_.wait_for(lock, std::chrono::milliseconds(100));
+            continue;
+        }
+
+        if (!ready_queue_->empty())
+        {
+            std::shared_ptr<Process> process = ready_queue_->pop(core_id);
+            if (process)
+            {
+                return process;
+            }
+        }
+
+        if (!block)
+        {
+            return nullptr;
+        }
+        queue_condition_.wait(lock);
+    }
+
+    // Pass on a wakeup this core may have consumed while retiring
+    queue_condition_.notify_one();
+    return nullptr;
+}
+
+void Scheduler::notifyQueue()
 {
-    delay_per_execution = delay;
+    // In replay or with hard pinning a specific core has to see the process it is waiting for.
+    if (trace_.isReplaying() || hard_pinning_)
+    {
+        queue_condition_.notify_all();
+    }
+    else
+    {
+        queue_condition_.notify_one();
+    }
 }
 
-void Scheduler::setCPUClock(Clock* clock)
+
+void Scheduler::signalReady()
 {
-    cpu_clock = clock;
+    std::lock_guard<std::mutex> lock(start_mutex_);
+    ready_threads++;
+    if (ready_threads == expected_threads_)
+    {
+        start_condition_.notify_all();
+    }
 }
 
-void Scheduler::setQuantumCycle(int quantum_cycle)
+bool Scheduler::isTimeSliced() const
 {
-    quantum_cycle = quantum_cycle;
+    return scheduler_algorithm == "rr" || scheduler_algorithm == "mlfq" || scheduler_algorithm == "srtf" || scheduler_algorithm == "edf";
 }
 
-void Scheduler::start()
+void Scheduler::runPool(int worker_index)
 {
-    is_running = true;
-    for (int i = 1; i <= cpu_count; ++i)
+    signalReady();
+
+    if (isTimeSliced())
     {
-        worker_threads_.emplace_back(&Scheduler::run, this, i);
+        lookahead_ticks_ > 0 ? schedulePDES<TimeSlicePolicy>(worker_index) : schedulePool<TimeSlicePolicy>(worker_index);
     }
-
+    else if (scheduler_algorithm == "fcfs" || scheduler_algorithm == "sjf")
     {
-        std::unique_lock<std::mutex> lock(start_mutex_);
-        start_condition_.wait(lock, [this]
-            {
-                return ready_threads == cpu_count;
-            });
+        lookahead_ticks_ > 0 ? schedulePDES<RunToCompletionPolicy>(worker_index) : schedulePool<RunToCompletionPolicy>(worker_index);
     }
 }
 
-void Scheduler::startMemoryLog()
+void Scheduler::run(int core_id)
 {
-    memory_log_ = true;
-    memory_logging_thread_ = std::thread([this]()
-        {
-            std::unique_lock<std::mutex> lock(cpu_clock->getMutex());
+    signalReady();
 
-            while (is_running)
-            {
-                // Wait for CPU clock tick increment
-                cpu_clock->getCondition().wait(lock);
+    if (isTimeSliced())
+    {
+        coroutine_mode_ ? scheduleCoroutines<TimeSlicePolicy>(core_id) : scheduleLoop<TimeSlicePolicy>(core_id);
+    }
+    else if (scheduler_algorithm == "fcfs" || scheduler_algorithm == "sjf")
+    {
+        coroutine_mode_ ? scheduleCoroutines<RunToCompletionPolicy>(core_id) : scheduleLoop<RunToCompletionPolicy>(core_id);
+    }
+}
 
-                bool any_core_active = false;
+int Scheduler::RunToCompletionPolicy::quantumLimit(IReadyQueue*, const std::shared_ptr<Process>&)
+{
+    return std::numeric_limits<int>::max();
+}
 
-                // Check if any core is active
-                for (int i = 1; i <= cpu_count; ++i)
-                {
-                    if (CoreStateManager::getInstance().getCoreState(i))
-                    {
-                        any_core_active = true;
-                        break;
-                    }
-                }
+int Scheduler::TimeSlicePolicy::quantumLimit(IReadyQueue* ready_queue, const std::shared_ptr<Process>& process)
+{
+    return ready_queue->getQuantum(process);
+}
 
-                // Increment active CPU count if at least one core is active
-                if (any_core_active)
-                {
-                    cpu_clock->incrementActiveCpuNum();
-                }
-            }
-        });
+bool Scheduler::RunToCompletionPolicy::waitsPerTick(int)
+{
+    return true;
 }
 
-void Scheduler::stop()
+bool Scheduler::TimeSlicePolicy::waitsPerTick(int delay_per_execution)
 {
-    is_running = false;
+    return delay_per_execution != 0;
+}
 
-    cpu_clock->getCondition().notify_all();
-    queue_condition_.notify_all();
+bool Scheduler::beginDispatch(const std::shared_ptr<Process>& process, int core_id, int& switch_cost)
+{
+    {
+        std::lock_guard<std::mutex> lock(active_threads_mutex_);
+        active_threads_++;
+        if (active_threads_ > cpu_count)
+        {
+            std::cerr << "Error: Exceeded CPU limit!" << std::endl;
+            active_threads_--;
+            return false;
+        }
+    }
 
-    for (auto& thread : worker_threads_)
+    if (!process->getMemory())
     {
-        if (thread.joinable())
+        void* memory = memory_allocator_->allocate(process);
+
+        if (!memory)
         {
-            thread.join();
+            // Couldn't fit: back to the tail of the queue and give the core a new job
+            process->setState(Process::READY);
+            requeueProcess(process, core_id, false);
+            {
+                std::lock_guard<std::mutex> lock(active_threads_mutex_);
+                active_threads_--;
+            }
+            CoreStateManager::getInstance().setCoreState(core_id, false, "");
+            notifyQueue();
+            return false;
         }
+
+        process->setAllocTime();
+        process->setMemory(memory);
     }
 
-    std::cout << "Scheduler fully stopped.\n";
+    process->setState(Process::ProcessState::RUNNING);
+    recordDispatch(process, core_id);
+    switch_cost = chargeSwitch(process, core_id);
+    process->setCPUCoreID(core_id);
+    CoreStateManager::getInstance().setCoreState(core_id, true, process->getName());
+    return true;
 }
 
-void Scheduler::clearQueue()
+void Scheduler::endDispatch(const std::shared_ptr<Process>& process, int core_id, int quantum, int quantum_limit, bool time_sliced)
 {
-    std::lock_guard<std::mutex> lock(queue_mutex_);
-    std::queue<std::shared_ptr<Process>> empty;
-    std::swap(process_queue_, empty);
-}
-
+    if (time_sliced)
+    {
+        latency(core_id, LATENCY_QUANTUM_UTILIZATION).record(static_cast<uint64_t>(quantum) * 100 / std::max(1, quantum_limit));
+    }
 
-void Scheduler::run(int core_id)
-{
+    if (process->getCommandCounter() < process->getLinesOfCode())
+    {
+        // Slice expired, core retiring or shutting down: hand the process
+        // back with its memory still allocated
+        process->setState(Process::ProcessState::READY);
+        trace_.record(localTick(core_id), core_id, process->getPID(), SchedulerTrace::PREEMPT);
+        requeueProcess(process, core_id, quantum >= quantum_limit);
+    }
+    else
     {
-        std::lock_guard<std::mutex> lock(start_mutex_);
-        ready_threads++;
-        if (ready_threads == cpu_count)
+        process->setState(Process::ProcessState::FINISHED);
+        recordFinish(process, core_id);
+        if (lookahead_ticks_ > 0)
+        {
+            // Cores still behind this tick must not see the memory free yet
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            postEvent(localTick(core_id), process, PendingEvent::FREE);
+        }
+        else
         {
-            start_condition_.notify_one();
+            memory_allocator_->deallocate(process);
+            process->setMemory(nullptr);
         }
+        GLOBAL_PM->archiveProcess(process);
     }
 
-    if (scheduler_algorithm == "rr")
     {
-        scheduleRR(core_id);
+        std::lock_guard<std::mutex> lock(active_threads_mutex_);
+        active_threads_--;
     }
-    else if (scheduler_algorithm == "fcfs")
+
+    CoreStateManager::getInstance().setCoreState(core_id, false, "");
+    notifyQueue();
+
+    if (time_sliced && adaptive_quantum_)
     {
-        scheduleFCFS(core_id);
+        adaptQuantum();
     }
 }
 
-void Scheduler::scheduleFCFS(int core_id)
+template <typename Policy>
+void Scheduler::scheduleLoop(int core_id)
 {
-    while (is_running && !GLOBAL_SHUTTING_DOWN)
+    while (is_running && !GLOBAL_SHUTTING_DOWN && !isRetiring(core_id))
     {
-        std::shared_ptr<Process> process;
+        std::shared_ptr<Process> process = takeProcess(core_id);
 
+        if (!process)
         {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_condition_.wait(lock, [this]
-                {
-                    return !process_queue_.empty() || !is_running;
-                });
-
-            if (!is_running)
-            {
-                break;
-            }
-
-            process = process_queue_.front();
-            process_queue_.pop();
+            break;
         }
 
+        int switch_cost;
+        if (!beginDispatch(process, core_id, switch_cost))
+        {
+            continue;
+        }
 
+        // The core stays busy while it pays the switch cost, so it counts as utilization
+        waitTicks(switch_cost, core_id);
 
-        if (process)
+        int quantum = 0;
+        int quantum_limit;
         {
-            {
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_++;
-                if (active_threads_ > cpu_count)
-                {
-                    std::cerr << "Error: Exceeded CPU limit!" << std::endl;
-                    active_threads_--;
-                    continue;
-                }
-            }
-
-            void* memory = process->getMemory();
+            std::lock_guard<std::mutex> lock(queue_mutex_);
+            quantum_limit = Policy::quantumLimit(ready_queue_, process);
+        }
+        int last_clock = cpu_clock->getCpuClock();
+        bool first_command_executed = false;
+        int cycle_counter = 0;
+        bool waits_per_tick = Policy::waitsPerTick(delay_per_execution);
 
-            if (memory)
+        while (process->getCommandCounter() < process->getLinesOfCode() && quantum < quantum_limit)
+        {
+            if (GLOBAL_SHUTTING_DOWN || isRetiring(core_id))
             {
-                process->setAllocTime();
-                process->setMemory(memory);
+                break;
             }
 
-            if (!memory)
+            if (waits_per_tick)
             {
-                memory = memory_allocator_->allocate(process);
+                last_clock = cpu_clock->waitForTick(last_clock);
 
-                /* ========== REPLACEMENT START ========== */
-                if (!memory) {
-                    /* Couldn’t fit – push back to tail of queue, mark READY, and continue */
-                    process->setState(Process::READY);
-                    {
-                        std::lock_guard<std::mutex> qlock(queue_mutex_);
-                        process_queue_.push(process);
-                    }
+                auto procs = GLOBAL_PM->getAllProcess();
+                for (auto& [name, p] : procs)
+                {
+                    if (p->getState() == Process::WAITING && p->isSleeping())
                     {
-                        std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                        active_threads_--;
+                        p->decrementSleepTick();
                     }
-                    CoreStateManager::getInstance().setCoreState(core_id, false, "");
-                    continue;                       // give the core a new job
                 }
-                process->setAllocTime();
-                process->setMemory(memory);
-                /* ==========  REPLACEMENT END  ========== */
             }
 
-
-            process->setState(Process::ProcessState::RUNNING);
-            process->setCPUCoreID(core_id);
-            CoreStateManager::getInstance().setCoreState(core_id, true, process->getName());
-
-            int last_clock = cpu_clock->getCpuClock();
-            bool first_command_executed = false;
-            int cycle_counter = 0;
-
-            while (process->getCommandCounter() < process->getLinesOfCode())
+            if (!first_command_executed || (++cycle_counter >= delay_per_execution))
             {
-                if (GLOBAL_SHUTTING_DOWN) {
-                    break;
+                // Without a delay a core retires a batch of instructions per tick
+                int batch = delay_per_execution == 0 ? instructions_per_tick_ : 1;
+                int executed = 0;
+                while (executed < batch && quantum < quantum_limit && process->getCommandCounter() < process->getLinesOfCode())
+                {
+                    int retired = process->getCommandCounter();
+                    process->executeCurrentCommand();
+                    // A fused superinstruction is charged for every line it retires
+                    int lines = std::max(1, process->getCommandCounter() - retired);
+                    executed += lines;
+                    quantum += lines;
                 }
+                core_instructions_[core_id - 1] += executed;
+                first_command_executed = true;
+                cycle_counter = 0;
 
+                if constexpr (Policy::time_sliced)
                 {
-                    std::unique_lock<std::mutex> lock(cpu_clock->getMutex());
-                    cpu_clock->getCondition().wait(lock, [&]
-                        {
-                            return cpu_clock->getCpuClock() > last_clock;
-                        });
-                    last_clock = cpu_clock->getCpuClock();
-
-                    auto procs = GLOBAL_PM->getAllProcess();
-                    for (auto& [name, p] : procs)
+                    if (quantum >= quantum_limit)
                     {
-                        if (p->getState() == Process::WAITING && p->isSleeping())
-                        {
-                            p->decrementSleepTick();
-                        }
+                        logMemoryState(snapshot_counter_.fetch_add(1));  // memory_stamp_<qq>.txt
                     }
                 }
-
-                if (!first_command_executed || (++cycle_counter >= delay_per_execution))
-                {
-                    process->executeCurrentCommand();
-                    first_command_executed = true;
-                    cycle_counter = 0;
-                }
             }
+        }
+
+        endDispatch(process, core_id, quantum, quantum_limit, Policy::time_sliced);
+    }
+}
+
+template <typename Policy>
+bool Scheduler::loadCore(VirtualCore& core, const std::shared_ptr<Process>& process)
+{
+    int switch_cost;
+    if (!beginDispatch(process, core.core_id, switch_cost))
+    {
+        return false;
+    }
+
+    // Only pool workers have a batch to stage into
+    process->setBatchedArithmetic(batched_arithmetic_ && pool_workers_ > 0 && instructions_per_tick_ == 1);
+
+    std::lock_guard<std::mutex> lock(queue_mutex_);
+    core.process = process;
+    core.quantum = 0;
+    core.quantum_limit = Policy::quantumLimit(ready_queue_, process);
+    core.cycle_counter = 0;
+    core.first_command_executed = false;
+    core.switch_ticks_remaining = switch_cost;
+    return true;
+}
+
+template <typename Policy>
+bool Scheduler::stepCore(VirtualCore& core, int tick, ArithmeticBatch* arithmetic)
+{
+    // Advance one virtual core by one clock tick. Never blocks. Returns true
+    // if the tick's instruction was staged into arithmetic; the caller then owns
+    // finishing the step through commitBatch.
+    auto woken = std::partition(core.sleepers.begin(), core.sleepers.end(), [tick](const VirtualCore::Sleeper& sleeper)
+        {
+            return sleeper.wake_tick > tick;
+        });
+    for (auto it = woken; it != core.sleepers.end(); ++it)
+    {
+        it->process->setSleepTicks(0);
+        it->process->setState(Process::READY);
+        requeueProcess(it->process, core.core_id, false);
+    }
+    if (woken != core.sleepers.end())
+    {
+        core.sleepers.erase(woken, core.sleepers.end());
+        notifyQueue();
+    }
+
+    if (!core.process)
+    {
+        std::shared_ptr<Process> process = takeProcess(core.core_id, false);
+        if (!process || !loadCore<Policy>(core, process))
+        {
+            return false;
+        }
+    }
+
+    if (core.switch_ticks_remaining > 0)
+    {
+        core.switch_ticks_remaining--;
+        return false;
+    }
+
+    if (core.first_command_executed && ++core.cycle_counter < delay_per_execution)
+    {
+        return false;
+    }
+
+    std::shared_ptr<Process> process = core.process;
+    int batch = delay_per_execution == 0 ? instructions_per_tick_ : 1;
+    int executed = 0;
+    ProcessTask::Suspend reason = ProcessTask::TICK;
+    while (executed < batch && core.quantum < core.quantum_limit && reason == ProcessTask::TICK)
+    {
+        int retired = process->getCommandCounter();
+        reason = process->getTask().resume();
+        // A fused superinstruction is charged for every line it retires; a
+        // staged ADD/SUBTRACT retires at commit and counts as one
+        int lines = std::max(1, process->getCommandCounter() - retired);
+        executed += lines;
+        core.quantum += lines;
+    }
+    core_instructions_[core.core_id - 1] += executed;
+    core.first_command_executed = true;
+    core.cycle_counter = 0;
 
-            process->setState(Process::ProcessState::FINISHED);
+    if (reason == ProcessTask::ALU && arithmetic)
+    {
+        core.arithmetic_slot = process->stageInto(*arithmetic);
+        return true;
+    }
+
+    completeStep<Policy>(core, tick, reason);
+    return false;
+}
 
+template <typename Policy>
+void Scheduler::completeStep(VirtualCore& core, int tick, ProcessTask::Suspend reason)
+{
+    std::shared_ptr<Process> process = core.process;
+    if (reason == ProcessTask::SLEEP)
+    {
+        // Off the core until the wake tick; memory stays allocated
+        core.sleepers.push_back({ tick + process->getSleepTicks(), process });
+        trace_.record(tick, core.core_id, process->getPID(), SchedulerTrace::PREEMPT);
+        {
+            std::lock_guard<std::mutex> lock(active_threads_mutex_);
+            active_threads_--;
+        }
+        CoreStateManager::getInstance().setCoreState(core.core_id, false, "");
+        core.process = nullptr;
+    }
+    else if (reason == ProcessTask::DONE || core.quantum >= core.quantum_limit)
+    {
+        if constexpr (Policy::time_sliced)
+        {
+            if (core.quantum >= core.quantum_limit)
             {
-                memory_allocator_->deallocate(process);
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_--;
+                logMemoryState(snapshot_counter_.fetch_add(1));  // memory_stamp_<qq>.txt
             }
-
-            queue_condition_.notify_one();
         }
+        endDispatch(process, core.core_id, core.quantum, core.quantum_limit, Policy::time_sliced);
+        core.process = nullptr;
+    }
+}
 
-        CoreStateManager::getInstance().setCoreState(core_id, false, "");
+template <typename Policy>
+void Scheduler::commitBatch(ArithmeticBatch& batch, std::vector<VirtualCore*>& staged)
+{
+    if (staged.empty())
+    {
+        return;
+    }
+
+    batch.run();
+    for (VirtualCore* core : staged)
+    {
+        std::shared_ptr<Process> process = core->process;
+        process->commitArithmetic(batch.getResult(core->arithmetic_slot));
+        bool done = process->getCommandCounter() >= process->getLinesOfCode();
+        completeStep<Policy>(*core, core->stepped_tick, done ? ProcessTask::DONE : ProcessTask::TICK);
+        core->busy = false;
     }
+    staged.clear();
+    batch.clear();
 }
 
-void Scheduler::scheduleRR(int core_id)
+void Scheduler::flushCore(VirtualCore& core, bool time_sliced)
 {
-    static std::atomic<int> snapshot_ctr{ 0 };
+    if (core.process)
+    {
+        endDispatch(core.process, core.core_id, core.quantum, core.quantum_limit, time_sliced);
+        core.process = nullptr;
+    }
+
+    // Sleepers on a stopping or retiring core go back to the ready queue awake
+    for (auto& sleeper : core.sleepers)
+    {
+        sleeper.process->setSleepTicks(0);
+        sleeper.process->setState(Process::READY);
+        requeueProcess(sleeper.process, core.core_id, false);
+    }
+    core.sleepers.clear();
+    notifyQueue();
+}
 
-    while (is_running)
+void Scheduler::retireCore(VirtualCore& core, bool time_sliced)
+{
+    flushCore(core, time_sliced);
     {
-        std::shared_ptr<Process> process;
+        // Set under the lock so removeCores can't miss the wakeup
+        std::lock_guard<std::mutex> retire_lock(retire_mutex_);
+        core.retired = true;
+    }
+    retire_condition_.notify_all();
+}
 
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
-            queue_condition_.wait(lock, [this]
-                {
-                    return !process_queue_.empty() || !is_running;
-                });
+template <typename Policy>
+void Scheduler::scheduleCoroutines(int core_id)
+{
+    // Per-core executor: the thread only waits on the clock or, with nothing
+    // to run or wake, on the ready queue.
+    VirtualCore& core = *virtual_cores_[core_id - 1];
+    int last_clock = cpu_clock->getCpuClock();
 
-            if (!is_running)
+    while (is_running && !GLOBAL_SHUTTING_DOWN && !isRetiring(core_id))
+    {
+        if (!core.process && core.sleepers.empty())
+        {
+            std::shared_ptr<Process> process = takeProcess(core_id);
+            if (!process)
             {
                 break;
             }
+            loadCore<Policy>(core, process);
+        }
+
+        last_clock = cpu_clock->waitForTick(last_clock);
+        stepCore<Policy>(core, last_clock);
+    }
+
+    flushCore(core, Policy::time_sliced);
+}
 
-            process = process_queue_.front();
-            process_queue_.pop();
+template <typename Policy>
+void Scheduler::schedulePool(int worker_index)
+{
+    // Pool worker: on every tick, step each virtual core that no other worker
+    // has stepped yet, starting from a different core per worker.
+    // The first pass steps the current tick, so a lockstep clock that is
+    // already waiting for this worker's arrival is released.
+    int last_clock = cpu_clock->getCpuClock() - 1;
+    ArithmeticBatch batch;
+    std::vector<VirtualCore*> staged;
+
+    while (true)
+    {
+        // Stop only between arriving and the next tick, so leaving the
+        // lockstep barrier never counts as a second arrival in one phase
+        last_clock = cpu_clock->waitForTick(last_clock);
+        if (!is_running || GLOBAL_SHUTTING_DOWN)
+        {
+            break;
         }
 
-        if (process)
+        int cores = cpu_count;
+        for (int i = 0; i < cores && is_running; ++i)
         {
+            VirtualCore& core = *virtual_cores_[(worker_index + i) % cores];
+            if (core.busy.exchange(true))
             {
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_++;
-                if (active_threads_ > cpu_count)
-                {
-                    std::cerr << "Error: Exceeded CPU limit!" << std::endl;
-                    active_threads_--;
-                    continue;
-                }
+                continue;
             }
 
-            void* memory = process->getMemory();
-
-            if (!memory)
+            if (core.stepped_tick < last_clock && !core.retired)
             {
-                memory = memory_allocator_->allocate(process);
-
-                if (memory)
+                core.stepped_tick = last_clock;
+                if (isRetiring(core.core_id))
                 {
-                    process->setAllocTime();
-                    process->setMemory(memory);
+                    retireCore(core, Policy::time_sliced);
                 }
-
-                if (!memory) {
-                    process->setState(Process::READY);
-                    {
-                        std::lock_guard<std::mutex> qlock(queue_mutex_);
-                        process_queue_.push(process);   // tail of RR queue
-                    }
-                    {
-                        std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                        active_threads_--;
-                    }
-                    CoreStateManager::getInstance().setCoreState(core_id, false, "");
-                    queue_condition_.notify_one();      // wake another worker
+                else if (stepCore<Policy>(core, last_clock, &batch))
+                {
+                    // Stays claimed until the batch commits
+                    staged.push_back(&core);
                     continue;
                 }
-                process->setAllocTime();
-                process->setMemory(memory);
             }
+            core.busy = false;
+        }
 
-            process->setState(Process::ProcessState::RUNNING);
-            process->setCPUCoreID(core_id);
-            CoreStateManager::getInstance().setCoreState(core_id, true, process->getName());
+        commitBatch<Policy>(batch, staged);
+        cpu_clock->arriveTick();
+    }
 
-            int quantum = 0;
-            int last_clock = cpu_clock->getCpuClock();
-            bool first_command_executed = true;
-            int cycle_counter = 0;
+    cpu_clock->leaveLockstep();
+
+    int cores = cpu_count;
+    for (int i = 0; i < cores; ++i)
+    {
+        VirtualCore& core = *virtual_cores_[i];
+        if (!core.busy.exchange(true))
+        {
+            if (!core.retired)
+            {
+                retireCore(core, Policy::time_sliced);
+            }
+            core.busy = false;
+        }
+    }
+}
+
+template <typename Policy>
+void Scheduler::schedulePDES(int worker_index)
+{
+    // Conservative PDES worker. A core's stepped_tick is its local clock and
+    // advances toward the published tick with no per-tick barrier, so a fast
+    // core does not wait for the slowest one. The clock holds the published
+    // tick within the lookahead of the slowest core, and requeues, arrivals
+    // and memory frees wait in pending_events_ until every core has reached
+    // their timestamp.
+    ArithmeticBatch batch;
+    std::vector<VirtualCore*> staged;
 
+    while (is_running && !GLOBAL_SHUTTING_DOWN)
+    {
+        int now = cpu_clock->getCpuClock();
+        bool stepped = false;
+
+        int cores = cpu_count;
+        for (int i = 0; i < cores && is_running; ++i)
+        {
+            VirtualCore& core = *virtual_cores_[(worker_index + i) % cores];
+            if (core.busy.exchange(true))
+            {
+                continue;
+            }
 
-            while (process->getCommandCounter() < process->getLinesOfCode() && quantum < quantum_cycle)
+            if (!core.retired)
             {
-                if (delay_per_execution != 0)
+                if (isRetiring(core.core_id))
                 {
-                    std::unique_lock<std::mutex> lock(cpu_clock->getMutex());
-                    cpu_clock->getCondition().wait(lock, [&]
-                        {
-                            return cpu_clock->getCpuClock() > last_clock;
-                        });
-                    last_clock = cpu_clock->getCpuClock();
-
-                    auto procs = GLOBAL_PM->getAllProcess();
-                    for (auto& [name, p] : procs)
-                    {
-                        if (p->getState() == Process::WAITING && p->isSleeping())
-                        {
-                            p->decrementSleepTick();
-                        }
-                    }
+                    retireCore(core, Policy::time_sliced);
                 }
-
-                if (!first_command_executed || (++cycle_counter >= delay_per_execution))
+                else if (core.stepped_tick < now)
                 {
-                    process->executeCurrentCommand();
-                    first_command_executed = false;
-                    cycle_counter = 0;
-                    quantum++;
-
-                    if (quantum >= quantum_cycle)
+                    int tick = core.stepped_tick + 1;
+                    core.stepped_tick = tick;
+                    stepped = true;
+                    if (stepCore<Policy>(core, tick, &batch))
                     {
-                        logMemoryState(snapshot_ctr.fetch_add(1));  // memory_stamp_<qq>.txt
+                        staged.push_back(&core);
+                        continue;
                     }
                 }
             }
+            core.busy = false;
+        }
 
-            quantum = 0;
-
-            std::this_thread::sleep_for(std::chrono::microseconds(2000));
+        commitBatch<Policy>(batch, staged);
+        advanceFloor();
 
-            if (process->getCommandCounter() < process->getLinesOfCode())
-            {
-                process->setState(Process::ProcessState::READY);
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                process_queue_.push(process);
-            }
-            else
-            {
-                process->setState(Process::ProcessState::FINISHED);
-                memory_allocator_->deallocate(process);
-                process->setMemory(nullptr);
-            }
+        if (!stepped)
+        {
+            // Every core this worker could claim has caught up
+            cpu_clock->waitForTick(now);
+        }
+    }
 
+    int cores = cpu_count;
+    for (int i = 0; i < cores; ++i)
+    {
+        VirtualCore& core = *virtual_cores_[i];
+        if (!core.busy.exchange(true))
+        {
+            if (!core.retired)
             {
-                std::lock_guard<std::mutex> lock(active_threads_mutex_);
-                active_threads_--;
+                retireCore(core, Policy::time_sliced);
             }
-
-            queue_condition_.notify_one();
+            core.busy = false;
         }
-
-        CoreStateManager::getInstance().setCoreState(core_id, false, "");
     }
+
+    // Nothing is behind any more: hand every held event over
+    releaseEvents(std::numeric_limits<int>::max());
 }
 
 void Scheduler::logMemoryState(int cycle)
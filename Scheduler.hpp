@@ -4,8 +4,14 @@
 #include "Clock.hpp"
 #include "Globals.hpp"
 #include "FlatMemoryAllocator.hpp"
+#include "SchedulerTrace.hpp"
+#include "IReadyQueue.hpp"
+#include "LatencyHistogram.hpp"
+#include "ArithmeticBatch.hpp"
+#include "ProcessTask.hpp"
 
 #include <queue>
+#include <deque>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -15,48 +21,280 @@
 #include <string>
 #include <map>
 #include <tuple>
+#include <chrono>
+#include <atomic>
+#include <functional>
 
 class Process;
 
 class Scheduler
 {
 public:
+    enum SwitchKind
+    {
+        SWITCH_SAME_PROCESS,
+        SWITCH_SAME_CORE,
+        SWITCH_MIGRATION,
+        SWITCH_KINDS
+    };
+
+    enum LatencyMetric
+    {
+        LATENCY_WAIT_TICKS,
+        LATENCY_WAIT_NS,
+        LATENCY_RESPONSE_TICKS,
+        LATENCY_RESPONSE_NS,
+        LATENCY_TURNAROUND_TICKS,
+        LATENCY_TURNAROUND_NS,
+        LATENCY_QUANTUM_UTILIZATION,
+        LATENCY_METRICS
+    };
+
     Scheduler(std::string scheduler_algo, int delays_per_exec, int n_cpu, int quantum_cycle, Clock* cpu_clock, IMemoryAllocator* memory_allocator);
+    ~Scheduler();
     void addProcess(std::shared_ptr<Process> process);
     void setAlgorithm(const std::string& algorithm);
     void setNumCPUs(int num);
     void setDelays(int delay);
     void setQuantumCycle(int quantum_cycle);
+    void setMLFQ(const std::vector<int>& quanta, int boost_ticks);
+    void setAgingRate(double aging_rate);
+    void setAffinity(int window, bool hard_pinning);
+    void setSwitchCosts(int same_process, int same_core, int migration);
+    void setAdaptiveQuantum(int min_quantum, int max_quantum, int period_ticks);
+    void setInstructionsPerTick(int instructions);
+    void setCoroutineMode(bool enabled);
+    void setWorkerPool(int workers, bool lockstep);
+    void setPDES(int workers, int lookahead);
+    void setBatchedArithmetic(bool enabled);
+    int getLookahead() const;
+    int getWorkerPoolSize() const;
+    void setWorkerCpus(const std::vector<int>& host_cpus);
+    std::vector<int> getWorkerAffinity();
+    void waitUntilStarted();
+    std::vector<double> getCoreThroughput();
+    int getCurrentQuantum();
+    long long getQuantumAdjustments() const;
+    int addCores(int count);
+    int removeCores(int count);
+    int getNumCPUs() const;
     void start();
     void stop();
     void clearQueue();
     void setCPUClock(Clock* cpu_clock);
+    void setTraceFile(const std::string& path);
+    bool loadReplay(const std::string& path);
+    SchedulerTrace& getTrace();
+    std::vector<size_t> getQueueLevelSizes();
+    double getMeanResponseTime() const;
+    void getTurnaroundStats(double& mean, int& p50, int& p99, size_t& count);
+    const std::string& getAlgorithm() const;
+    void getDeadlineStats(long long& met, long long& missed, std::vector<long long>& lateness_histogram);
+    std::vector<long long> getCoreMigrations();
+    void getSwitchStats(std::vector<long long>& counts, std::vector<long long>& ticks);
+    static const char* switchKindName(SwitchKind kind);
+    void mergeLatency(LatencyMetric metric, LatencyHistogram& merged);
+    static const char* latencyMetricName(LatencyMetric metric);
 
 private:
+    // State of one simulated core when cores are advanced tick by tick
+    // instead of each owning a blocking loop.
+    struct VirtualCore
+    {
+        struct Sleeper
+        {
+            int wake_tick;
+            std::shared_ptr<Process> process;
+        };
+
+        int core_id = 0;
+        std::shared_ptr<Process> process;
+        int quantum = 0;
+        int quantum_limit = 0;
+        int cycle_counter = 0;
+        bool first_command_executed = false;
+        int switch_ticks_remaining = 0;
+        size_t arithmetic_slot = 0;
+        std::vector<Sleeper> sleepers;
+        std::atomic<bool> busy{ false };
+        std::atomic<int> stepped_tick{ -1 };
+        std::atomic<bool> retired{ false };
+    };
+
     void run(int core_id);
-    void scheduleFCFS(int core_id);
-    void scheduleRR(int core_id);
+    void runPool(int worker_index);
+    void signalReady();
+    // Compile-time hooks for scheduleLoop. The ready queue decides order;
+    // the policy decides whether a dispatch is time sliced.
+    struct RunToCompletionPolicy
+    {
+        static constexpr bool time_sliced = false;
+        static int quantumLimit(IReadyQueue* ready_queue, const std::shared_ptr<Process>& process);
+        static bool waitsPerTick(int delay_per_execution);
+    };
+
+    struct TimeSlicePolicy
+    {
+        static constexpr bool time_sliced = true;
+        static int quantumLimit(IReadyQueue* ready_queue, const std::shared_ptr<Process>& process);
+        // Without a delay a time-sliced core runs its quantum back to back
+        static bool waitsPerTick(int delay_per_execution);
+    };
+
+    template <typename Policy>
+    void scheduleLoop(int core_id);
+    template <typename Policy>
+    void scheduleCoroutines(int core_id);
+    template <typename Policy>
+    void schedulePool(int worker_index);
+    template <typename Policy>
+    void schedulePDES(int worker_index);
+    template <typename Policy>
+    bool loadCore(VirtualCore& core, const std::shared_ptr<Process>& process);
+    template <typename Policy>
+    bool stepCore(VirtualCore& core, int tick, ArithmeticBatch* arithmetic = nullptr);
+    template <typename Policy>
+    void completeStep(VirtualCore& core, int tick, ProcessTask::Suspend reason);
+    template <typename Policy>
+    void commitBatch(ArithmeticBatch& batch, std::vector<VirtualCore*>& staged);
+    void flushCore(VirtualCore& core, bool time_sliced);
+    void retireCore(VirtualCore& core, bool time_sliced);
+    bool beginDispatch(const std::shared_ptr<Process>& process, int core_id, int& switch_cost);
+    void endDispatch(const std::shared_ptr<Process>& process, int core_id, int quantum, int quantum_limit, bool time_sliced);
+    std::shared_ptr<Process> takeProcess(int core_id, bool block = true);
+    void notifyQueue();
+    void recordDispatch(const std::shared_ptr<Process>& process, int core_id);
+    void recordFinish(const std::shared_ptr<Process>& process, int core_id);
+    int chargeSwitch(const std::shared_ptr<Process>& process, int core_id);
+    void waitTicks(int ticks, int core_id);
+    void adaptQuantum();
+    // Cross-core event held back until every core's local clock reaches it
+    struct PendingEvent
+    {
+        enum Kind
+        {
+            ARRIVE,
+            READY,
+            READY_EXPIRED,
+            FREE
+        };
+
+        int tick;
+        long long sequence;
+        std::shared_ptr<Process> process;
+        Kind kind;
+
+        bool operator>(const PendingEvent& other) const
+        {
+            return tick != other.tick ? tick > other.tick : sequence > other.sequence;
+        }
+    };
+
+    void markReady(const std::shared_ptr<Process>& process, int tick);
+    int localTick(int core_id) const;
+    void requeueProcess(const std::shared_ptr<Process>& process, int core_id, bool used_full_quantum);
+    void postEvent(int tick, const std::shared_ptr<Process>& process, PendingEvent::Kind kind);
+    void releaseEvents(int floor);
+    void advanceFloor();
+    void initCore(int core_id);
+    LatencyHistogram& latency(int core_id, LatencyMetric metric);
+    static long long nowNs();
+    void createReadyQueue();
+    bool isRetiring(int core_id) const;
+    bool isTimeSliced() const;
+    void pinWorker(size_t index);
     void startMemoryLog();
     void logMemoryState(int cycle);
 
     bool memory_log_ = false;
     bool is_running;
     int active_threads_;
-    int cpu_count;
-    int delay_per_execution;
-    int quantum_cycle;
     int ready_threads;
     std::string scheduler_algorithm;
-    std::queue<std::shared_ptr<Process>> process_queue_;
+    int delay_per_execution;
+    std::atomic<int> cpu_count;
+    int quantum_cycle;
+    Clock* cpu_clock;
+    IMemoryAllocator* memory_allocator_;
+    IReadyQueue* ready_queue_;
+    std::vector<int> mlfq_quanta_;
+    int mlfq_boost_ticks_ = 100;
+    double aging_rate_ = 0.0;
+    int affinity_window_ = 0;
+    bool hard_pinning_ = false;
+    std::vector<long long> core_migrations_;
+    static constexpr int MAX_CORES = 1024;
+    std::vector<std::atomic<bool>> core_retiring_ = std::vector<std::atomic<bool>>(MAX_CORES);
+    std::mutex cores_mutex_;
+    // Serializes addCores/removeCores; removeCores drops cores_mutex_ while
+    // it waits for a retiring worker
+    std::mutex resize_mutex_;
+    // Context-switch overhead in simulated ticks, indexed by SwitchKind
+    int switch_cost_[SWITCH_KINDS] = { 0, 2, 4 };
+    // Without explicit costs, run-to-completion policies charge nothing
+    bool switch_costs_configured_ = false;
+    std::atomic<long long> switch_count_[SWITCH_KINDS] = {};
+    std::atomic<long long> switch_ticks_[SWITCH_KINDS] = {};
+    std::vector<long long> last_pid_on_core_ = std::vector<long long>(MAX_CORES, -1);
+    bool adaptive_quantum_ = false;
+    int quantum_min_ = 1;
+    int quantum_max_ = 1;
+    int adapt_period_ticks_ = 100;
+    std::atomic<int> next_adapt_tick_{ 0 };
+    std::atomic<long long> quantum_adjustments_{ 0 };
+    std::atomic<int> snapshot_counter_{ 0 };
+    // Instructions a core may retire per clock tick when delay-per-exec is 0
+    int instructions_per_tick_ = 1;
+    bool coroutine_mode_ = false;
+    int pool_workers_ = 0;
+    bool tick_lockstep_ = false;
+    // Conservative PDES: how far any core may run past the slowest (0 = off)
+    int lookahead_ticks_ = 0;
+    // Pool workers gather ADD/SUBTRACT across cores into one ArithmeticBatch per
+    // pass. Staging ends the core's tick, so only used with instructions_per_tick_ 1.
+    bool batched_arithmetic_ = false;
+    std::atomic<int> pdes_floor_{ 0 };
+    std::priority_queue<PendingEvent, std::vector<PendingEvent>, std::greater<PendingEvent>> pending_events_;
+    long long event_sequence_ = 0;
+    int expected_threads_ = 0;
+    std::vector<std::unique_ptr<VirtualCore>> virtual_cores_ = std::vector<std::unique_ptr<VirtualCore>>(MAX_CORES);
+    std::mutex retire_mutex_;
+    std::condition_variable retire_condition_;
+    std::vector<std::atomic<long long>> core_instructions_ = std::vector<std::atomic<long long>>(MAX_CORES);
+    std::chrono::steady_clock::time_point start_time_;
+    struct CoreLatency
+    {
+        LatencyHistogram metrics[LATENCY_METRICS];
+    };
+    // Created before a core's worker starts and kept after it retires
+    std::vector<std::unique_ptr<CoreLatency>> core_latency_ = std::vector<std::unique_ptr<CoreLatency>>(MAX_CORES);
+    // Totals at the previous adaptation, so each decision sees one window only
+    int last_adapt_tick_ = 0;
+    long long last_switch_ticks_ = 0;
+    long long last_response_total_ = 0;
+    long long last_response_count_ = 0;
+    double last_window_response_ = -1.0;
+    std::mutex adapt_mutex_;
+    std::vector<int> turnaround_samples_;
+    // Bucket 0 counts deadlines met; bucket k counts lateness in [2^(k-1), 2^k) ticks.
+    static constexpr int LATENESS_BUCKETS = 17;
+    long long deadlines_met_ = 0;
+    long long deadlines_missed_ = 0;
+    std::vector<long long> lateness_histogram_ = std::vector<long long>(LATENESS_BUCKETS, 0);
+    std::mutex stats_mutex_;
+    std::atomic<long long> response_time_total_{ 0 };
+    std::atomic<long long> response_count_{ 0 };
+    SchedulerTrace trace_;
     std::vector<std::thread> worker_threads_;
+    std::vector<int> worker_cpus_;
+    std::vector<int> worker_host_cpu_;
     std::mutex queue_mutex_;
     std::mutex active_threads_mutex_;
     std::condition_variable queue_condition_;
     std::mutex start_mutex_;
     std::mutex log_mutex_;
     std::condition_variable start_condition_;
-    Clock* cpu_clock;
-    IMemoryAllocator* memory_allocator_;
+    bool started_ = false;
     std::thread memory_logging_thread_;
 };
 
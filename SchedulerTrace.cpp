@@ -0,0 +1,166 @@
+#include "SchedulerTrace.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+void SchedulerTrace::enableRecording(const std::string& path)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    recording_ = !path.empty();
+    path_ = path;
+    entries_.clear();
+}
+
+bool SchedulerTrace::isRecording() const
+{
+    return recording_;
+}
+
+void SchedulerTrace::record(int tick, int core, size_t pid, Event event)
+{
+    if (!recording_)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    entries_.push_back({ tick, core, pid, event });
+}
+
+bool SchedulerTrace::save()
+{
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    if (!recording_)
+    {
+        return false;
+    }
+
+    std::ofstream out_file(path_);
+    if (!out_file.is_open())
+    {
+        std::cerr << "Error: Unable to open the file for writing: " << path_ << std::endl;
+        return false;
+    }
+
+    out_file << "# tick core pid event" << std::endl;
+    for (const auto& entry : entries_)
+    {
+        out_file << entry.tick << " " << entry.core << " " << entry.pid << " " << eventName(entry.event) << "\n";
+    }
+    out_file.close();
+
+    std::cout << "Scheduler trace saved to " << path_ << " (" << entries_.size() << " events)\n";
+    return true;
+}
+
+bool SchedulerTrace::loadReplay(const std::string& path)
+{
+    std::ifstream in_file(path);
+    if (!in_file.is_open())
+    {
+        std::cerr << "[ERROR] Unable to open replay trace: " << path << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    replay_.clear();
+    replay_length_ = 0;
+    divergences_ = 0;
+
+    std::string line;
+    while (std::getline(in_file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+
+        std::istringstream iss(line);
+        Entry entry;
+        std::string event;
+        if (!(iss >> entry.tick >> entry.core >> entry.pid >> event))
+        {
+            continue;
+        }
+
+        // Only dispatches steer the replay; the other events are informational.
+        if (event == eventName(DISPATCH))
+        {
+            entry.event = DISPATCH;
+            replay_[entry.core].push_back(entry);
+            replay_length_++;
+        }
+    }
+
+    replaying_ = true;
+    return true;
+}
+
+bool SchedulerTrace::isReplaying() const
+{
+    return replaying_;
+}
+
+bool SchedulerTrace::getExpected(int core, size_t& pid, int& tick)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    auto it = replay_.find(core);
+    if (it == replay_.end() || it->second.empty())
+    {
+        return false;
+    }
+
+    pid = it->second.front().pid;
+    tick = it->second.front().tick;
+    return true;
+}
+
+void SchedulerTrace::advanceReplay(int core)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    auto it = replay_.find(core);
+    if (it != replay_.end() && !it->second.empty())
+    {
+        it->second.pop_front();
+    }
+}
+
+void SchedulerTrace::abandonReplay(int core)
+{
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    auto it = replay_.find(core);
+    if (it != replay_.end())
+    {
+        it->second.clear();
+    }
+    divergences_++;
+}
+
+size_t SchedulerTrace::getReplayLength() const
+{
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    return replay_length_;
+}
+
+size_t SchedulerTrace::getDivergences() const
+{
+    std::lock_guard<std::mutex> lock(trace_mutex_);
+    return divergences_;
+}
+
+const char* SchedulerTrace::eventName(Event event)
+{
+    switch (event)
+    {
+    case ARRIVE:
+        return "ARRIVE";
+    case DISPATCH:
+        return "DISPATCH";
+    case PREEMPT:
+        return "PREEMPT";
+    case FINISH:
+        return "FINISH";
+    }
+    return "UNKNOWN";
+}
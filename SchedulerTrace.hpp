@@ -0,0 +1,59 @@
+#ifndef SCHEDULER_TRACE_H
+#define SCHEDULER_TRACE_H
+
+#include <deque>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Records (tick, core, pid, event) tuples while the scheduler runs and, in replay
+// mode, hands each core the pid it dispatched next in a previously saved trace.
+class SchedulerTrace
+{
+public:
+    enum Event
+    {
+        ARRIVE,
+        DISPATCH,
+        PREEMPT,
+        FINISH
+    };
+
+    struct Entry
+    {
+        int tick;
+        int core;
+        size_t pid;
+        Event event;
+    };
+
+    static constexpr int REPLAY_SLACK_TICKS = 5000;
+
+    void enableRecording(const std::string& path);
+    bool isRecording() const;
+    void record(int tick, int core, size_t pid, Event event);
+    bool save();
+
+    bool loadReplay(const std::string& path);
+    bool isReplaying() const;
+    bool getExpected(int core, size_t& pid, int& tick);
+    void advanceReplay(int core);
+    void abandonReplay(int core);
+    size_t getReplayLength() const;
+    size_t getDivergences() const;
+
+    static const char* eventName(Event event);
+
+private:
+    bool recording_ = false;
+    bool replaying_ = false;
+    std::string path_;
+    std::vector<Entry> entries_;
+    std::map<int, std::deque<Entry>> replay_;
+    size_t replay_length_ = 0;
+    size_t divergences_ = 0;
+    mutable std::mutex trace_mutex_;
+};
+
+#endif
@@ -0,0 +1,91 @@
+#include "ShortestJobReadyQueue.hpp"
+
+#include <algorithm>
+
+ShortestJobReadyQueue::ShortestJobReadyQueue(int quantum_cycle, double aging_rate, Clock* cpu_clock)
+    : quantum_cycle(quantum_cycle), aging_rate(aging_rate), next_sequence(0), cpu_clock(cpu_clock)
+{
+}
+
+bool ShortestJobReadyQueue::compare(const Entry& a, const Entry& b)
+{
+    // std heap functions build a max-heap; invert so the smallest key is on top
+    if (a.key != b.key)
+    {
+        return a.key > b.key;
+    }
+    return a.sequence > b.sequence;
+}
+
+void ShortestJobReadyQueue::push(std::shared_ptr<Process> process)
+{
+    double remaining = process->getLinesOfCode() - process->getCommandCounter();
+    heap.push_back({ remaining + aging_rate * cpu_clock->getCpuClock(), next_sequence++, process });
+    std::push_heap(heap.begin(), heap.end(), compare);
+}
+
+void ShortestJobReadyQueue::requeue(std::shared_ptr<Process> process, bool)
+{
+    push(process);
+}
+
+std::shared_ptr<Process> ShortestJobReadyQueue::pop(int)
+{
+    if (heap.empty())
+    {
+        return nullptr;
+    }
+
+    std::pop_heap(heap.begin(), heap.end(), compare);
+    std::shared_ptr<Process> process = heap.back().process;
+    heap.pop_back();
+    return process;
+}
+
+std::shared_ptr<Process> ShortestJobReadyQueue::remove(size_t pid)
+{
+    auto it = std::find_if(heap.begin(), heap.end(), [pid](const Entry& entry)
+        {
+            return entry.process->getPID() == pid;
+        });
+
+    if (it == heap.end())
+    {
+        return nullptr;
+    }
+
+    std::shared_ptr<Process> process = it->process;
+    heap.erase(it);
+    std::make_heap(heap.begin(), heap.end(), compare);
+    return process;
+}
+
+bool ShortestJobReadyQueue::empty() const
+{
+    return heap.empty();
+}
+
+size_t ShortestJobReadyQueue::size() const
+{
+    return heap.size();
+}
+
+void ShortestJobReadyQueue::clear()
+{
+    heap.clear();
+}
+
+int ShortestJobReadyQueue::getQuantum(const std::shared_ptr<Process>&) const
+{
+    return quantum_cycle;
+}
+
+void ShortestJobReadyQueue::setQuantum(int quantum_cycle)
+{
+    this->quantum_cycle = quantum_cycle;
+}
+
+std::vector<size_t> ShortestJobReadyQueue::getLevelSizes() const
+{
+    return { heap.size() };
+}
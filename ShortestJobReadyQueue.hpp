@@ -0,0 +1,44 @@
+#ifndef SHORTEST_JOB_READY_QUEUE_H
+#define SHORTEST_JOB_READY_QUEUE_H
+
+#include "IReadyQueue.hpp"
+#include "Clock.hpp"
+#include <cstdint>
+
+// Binary min-heap keyed on remaining instructions, used by "sjf" and "srtf".
+// Aging credits a waiting process aging_rate instructions per tick waited.
+// Every process ages at the same rate, so the key can be fixed at enqueue time
+// as remaining + aging_rate * enqueue_tick without breaking the heap order.
+class ShortestJobReadyQueue : public IReadyQueue
+{
+public:
+    ShortestJobReadyQueue(int quantum_cycle, double aging_rate, Clock* cpu_clock);
+    void push(std::shared_ptr<Process> process) override;
+    void requeue(std::shared_ptr<Process> process, bool used_full_quantum) override;
+    std::shared_ptr<Process> pop(int core_id) override;
+    std::shared_ptr<Process> remove(size_t pid) override;
+    bool empty() const override;
+    size_t size() const override;
+    void clear() override;
+    int getQuantum(const std::shared_ptr<Process>& process) const override;
+    std::vector<size_t> getLevelSizes() const override;
+    void setQuantum(int quantum_cycle) override;
+
+private:
+    struct Entry
+    {
+        double key;
+        uint64_t sequence;
+        std::shared_ptr<Process> process;
+    };
+
+    static bool compare(const Entry& a, const Entry& b);
+
+    int quantum_cycle;
+    double aging_rate;
+    uint64_t next_sequence;
+    std::vector<Entry> heap;
+    Clock* cpu_clock;
+};
+
+#endif
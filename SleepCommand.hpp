@@ -2,7 +2,7 @@
 #define SLEEP_COMMAND_H
 
 #include "ICommand.hpp"
-#include "ProcessManager.hpp"
+#include "Globals.hpp"
 
 #include <fstream>
 #include <iomanip>
@@ -10,58 +10,39 @@
 #include <chrono>
 #include <vector>
 
-extern ProcessManager* GLOBAL_PM;
-
 class SleepCommand : public ICommand
 {
 public:
-    SleepCommand(int pid, int core, uint8_t ticks, std::vector<std::string>* log_list)
-        : ICommand(pid, CommandType::SLEEP), core_(core), ticks_(ticks), log_list_(log_list)
+    explicit SleepCommand(uint8_t ticks)
+        : ICommand(CommandType::SLEEP), ticks_(ticks)
     {
     }
 
-    void execute() override
+    void execute(ExecutionContext& context) const override
     {
         if (GLOBAL_SHUTTING_DOWN)
             return;
-        
-        auto processes = GLOBAL_PM->getAllProcess();
-        for (auto& [name, proc] : processes)
-        {
-            if (proc->getPID() == pid_)
-            {
-                proc->setSleepTicks(ticks_);
-                proc->setState(Process::WAITING);
 
-                std::ostringstream oss;
-                oss << getCurrentTimestamp() << " Core:" << core_;
-                if (sub_level_ > 0) oss << " [SUBCOMMAND-" << sub_level_ << "]";
-                oss << " \"SLEEP for " << std::to_string(ticks_) << " ticks.\"";
+        context.sleep_ticks = ticks_;
 
-                std::string log_line = oss.str();
+        std::ostringstream oss;
+        oss << getCurrentTimestamp() << " Core:" << context.core;
+        if (sub_level_ > 0) oss << " [SUBCOMMAND-" << sub_level_ << "]";
+        oss << " \"SLEEP for " << std::to_string(ticks_) << " ticks.\"";
 
-                std::ofstream outfile(name + ".txt", std::ios::app);
-                outfile << log_line << std::endl;
-                outfile.close();
+        std::string log_line = oss.str();
 
-                if (log_list_) log_list_->push_back(log_line);
-                break;
-            }
-        }
+        std::ofstream outfile(std::string(context.name) + ".txt", std::ios::app);
+        outfile << log_line << std::endl;
+        outfile.close();
 
-    }
-
-    void setCore(int core) override
-    {
-        core_ = core;
+        if (context.log_list) context.log_list->push_back(log_line);
     }
 
 private:
-    int core_;
     uint8_t ticks_;
-    std::vector<std::string>* log_list_;
 
-    std::string getCurrentTimestamp()
+    std::string getCurrentTimestamp() const
     {
         auto now = std::chrono::system_clock::now();
         std::time_t time_now = std::chrono::system_clock::to_time_t(now);
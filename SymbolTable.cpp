@@ -3,11 +3,16 @@
 
 SymbolTable::SymbolTable() {}
 
-void SymbolTable::insert(const std::string& symbol, const ST& entry) {
-    table[symbol] = entry;
+void SymbolTable::insert(std::string_view symbol, const ST& entry) {
+    auto it = table.find(symbol);
+    if (it != table.end()) {
+        it->second = entry;
+        return;
+    }
+    table.emplace(std::string(symbol), entry);
 }
 
-ST SymbolTable::fetch(const std::string& symbol) const {
+ST SymbolTable::fetch(std::string_view symbol) const {
     auto it = table.find(symbol);
     if (it != table.end()) {
         return it->second;
@@ -15,6 +20,24 @@ ST SymbolTable::fetch(const std::string& symbol) const {
     return ST{ ST::STRING, "" };
 }
 
+void SymbolTable::store(std::string_view symbol, uint16_t value) {
+    auto it = table.find(symbol);
+    if (it != table.end()) {
+        it->second.type = ST::UINT16;
+        it->second.number = value;
+        return;
+    }
+    table.emplace(std::string(symbol), ST(value));
+}
+
+uint16_t SymbolTable::load(std::string_view symbol) const {
+    auto it = table.find(symbol);
+    if (it != table.end() && it->second.type == ST::UINT16) {
+        return it->second.number;
+    }
+    return 0;
+}
+
 size_t SymbolTable::size() const {
 	return table.size();
 }
\ No newline at end of file
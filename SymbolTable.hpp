@@ -3,18 +3,30 @@
 
 #include <unordered_map>  
 #include <string>  
+#include <string_view>  
+#include <functional>  
 #include "ST.hpp"  
 
 class SymbolTable {
 public:  
    SymbolTable();  
 
-   void insert(const std::string& symbol, const ST& entry);  
-   ST fetch(const std::string& symbol) const;  
+   void insert(std::string_view symbol, const ST& entry);  
+   ST fetch(std::string_view symbol) const;  
+   // Typed access for DECLARE, ADD and SUBTRACT, without a string round trip;  
+   // load returns 0 for a symbol that is missing or not UINT16  
+   void store(std::string_view symbol, uint16_t value);  
+   uint16_t load(std::string_view symbol) const;  
    size_t size() const;  
 
 private:  
-   std::unordered_map<std::string, ST> table;  
+   // Transparent so arena-backed names can be looked up without a copy  
+   struct SymbolHash {
+       using is_transparent = void;
+       size_t operator()(std::string_view symbol) const { return std::hash<std::string_view>{}(symbol); }
+   };
+
+   std::unordered_map<std::string, ST, SymbolHash, std::equal_to<>> table;  
 };  
 
 #endif
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "ThreadAffinity.hpp"
+
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
+#endif
+
+std::vector<int> ThreadAffinity::parseCpuList(const std::string& spec)
+{
+    // Comma-separated CPUs and ranges, e.g. "0,2,4-7". Bad entries are
+    // skipped with a warning; the rest of the list still applies.
+    int limit = static_cast<int>(std::thread::hardware_concurrency());
+#ifdef __linux__
+    if (limit <= 0 || limit > CPU_SETSIZE)
+    {
+        limit = CPU_SETSIZE;
+    }
+#endif
+
+    std::vector<int> cpus;
+    std::istringstream iss(spec);
+    std::string item;
+    while (std::getline(iss, item, ','))
+    {
+        int first = 0;
+        int last = 0;
+        char dash = 0;
+        std::istringstream range(item);
+        bool valid = static_cast<bool>(range >> first) && first >= 0;
+        last = first;
+        if (valid && range >> dash)
+        {
+            valid = dash == '-' && range >> last;
+        }
+        if (!valid || !(range >> std::ws).eof())
+        {
+            std::cerr << "[WARNING] Ignoring malformed CPU list entry \"" << item << "\"." << std::endl;
+            continue;
+        }
+        if (last < first)
+        {
+            std::cerr << "[WARNING] Ignoring reversed CPU range \"" << item << "\"." << std::endl;
+            continue;
+        }
+        if (limit > 0 && last >= limit)
+        {
+            std::cerr << "[WARNING] Ignoring CPU list entry \"" << item << "\": host has CPUs 0-" << limit - 1 << "." << std::endl;
+            continue;
+        }
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+bool ThreadAffinity::pin(std::thread& thread, int host_cpu, std::string& error)
+{
+#ifdef __linux__
+    if (host_cpu < 0 || host_cpu >= CPU_SETSIZE)
+    {
+        error = "host CPU " + std::to_string(host_cpu) + " out of range";
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(host_cpu, &set);
+    int result = pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set);
+    if (result != 0)
+    {
+        error = "cannot pin to host CPU " + std::to_string(host_cpu) + ": " + std::strerror(result);
+        return false;
+    }
+    return true;
+#else
+    error = "thread pinning is not supported on this platform";
+    return false;
+#endif
+}
+
+bool ThreadAffinity::setRealtime(std::thread& thread, std::string& error)
+{
+#ifdef __linux__
+    // Lowest FIFO priority is enough to run ahead of every normal thread
+    sched_param param;
+    param.sched_priority = sched_get_priority_min(SCHED_FIFO);
+    int result = pthread_setschedparam(thread.native_handle(), SCHED_FIFO, &param);
+    if (result != 0)
+    {
+        error = std::string("cannot switch to SCHED_FIFO: ") + std::strerror(result);
+        return false;
+    }
+    return true;
+#else
+    error = "real-time scheduling is not supported on this platform";
+    return false;
+#endif
+}
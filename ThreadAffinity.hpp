@@ -0,0 +1,20 @@
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <string>
+#include <thread>
+#include <vector>
+
+// Host placement for simulator threads: pins a thread to one host CPU and
+// raises it to a real-time scheduling class. Only Linux supports either;
+// elsewhere, and when the host refuses, the call fails with a reason so the
+// caller can warn and carry on unpinned.
+class ThreadAffinity
+{
+public:
+    static std::vector<int> parseCpuList(const std::string& spec);
+    static bool pin(std::thread& thread, int host_cpu, std::string& error);
+    static bool setRealtime(std::thread& thread, std::string& error);
+};
+
+#endif